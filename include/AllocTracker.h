@@ -0,0 +1,98 @@
+#ifndef ALLOCTRACKER_H
+#define ALLOCTRACKER_H
+
+#include <SDL2/SDL.h>
+#include <cstdio>
+
+// What heap allocations are attributed to
+enum class AllocTag : Uint8 {
+    OTHER,
+    WORLD,
+    BULLETS,
+    ENEMIES,
+    OBSTACLES,
+    PARTICLES,
+    TERRAIN,
+    SPRITES,
+    REWIND,
+    RENDER,
+    IO,
+    AUDIO,
+    COUNT
+};
+
+// Heap allocation instrumentation. Built only with `make ALLOC_TRACKING=1`,
+// which defines ALLOC_TRACKING and replaces the global operator new and
+// delete to count every allocation made through them. Without it the scopes
+// below compile to nothing and the tracker reports that it isn't built in.
+//
+// Allocations are charged to the tag of the innermost AllocScope on the
+// allocating thread, and frees to the tag they were allocated under. Memory
+// SDL allocates with malloc (textures, surfaces) isn't seen.
+#ifdef ALLOC_TRACKING
+
+struct AllocContext {
+    AllocTag tag;
+    bool guarded;   // Inside an armed AllocGuard
+};
+
+inline thread_local AllocContext allocContext = {AllocTag::OTHER, false};
+
+// Charge allocations on this thread to a tag until the scope ends
+class AllocScope {
+private:
+    AllocTag previous;
+
+public:
+    explicit AllocScope(AllocTag tag) : previous(allocContext.tag) { allocContext.tag = tag; }
+    ~AllocScope() { allocContext.tag = previous; }
+    
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+};
+
+// While armed, any allocation on this thread aborts with the tag and size,
+// so a debugger stops at the offending call
+class AllocGuard {
+private:
+    bool previous;
+
+public:
+    explicit AllocGuard(bool armed) : previous(allocContext.guarded) { allocContext.guarded = armed || previous; }
+    ~AllocGuard() { allocContext.guarded = previous; }
+    
+    AllocGuard(const AllocGuard&) = delete;
+    AllocGuard& operator=(const AllocGuard&) = delete;
+};
+
+#else
+
+class AllocScope {
+public:
+    explicit AllocScope(AllocTag) {}
+};
+
+class AllocGuard {
+public:
+    explicit AllocGuard(bool) {}
+};
+
+#endif
+
+// Session-wide allocation statistics, kept by the replacement operators
+class AllocTracker {
+public:
+    // Whether this build counts allocations at all
+    static bool isBuiltIn();
+    
+    // Close the current frame's allocation and byte counts
+    static void endFrame();
+    
+    // Per-frame averages and worst frame, then allocations, bytes, live and
+    // peak live bytes per tag
+    static void printReport(FILE* out);
+    
+    static const char* getTagName(AllocTag tag);
+};
+
+#endif
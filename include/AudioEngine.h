@@ -0,0 +1,125 @@
+#ifndef AUDIOENGINE_H
+#define AUDIOENGINE_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Sound effects, in increasing priority for the one-shots
+enum class Sound : Uint8 {
+    ROTOR,          // Loop while playing
+    GUNFIRE,
+    HIT,
+    EXPLOSION,
+    CRASH,
+    COUNT
+};
+
+// Sound effects on SDL_mixer. Every sample is synthesized at init in the
+// device's format, so nothing is loaded or decoded while playing.
+//
+// The game thread only ever pushes triggers onto a fixed single-producer,
+// single-consumer ring and posts a semaphore; it never takes a lock, waits
+// or allocates. A dispatcher thread drains the ring and talks to the mixer.
+// Triggers of the same sound drained together play as one louder voice.
+// One-shots share a fixed pool of voices: each sound has a limit on how
+// many of its voices may play at once (past it, its oldest voice restarts),
+// and when every voice is busy a sound takes over the oldest voice of the
+// lowest priority not above its own, or is refused. A chain of twenty
+// explosions on one frame therefore costs one voice, not twenty.
+//
+// With SDL_AUDIODRIVER=dummy everything runs the same without a sound card.
+class AudioEngine {
+public:
+    static constexpr int VOICES = 12;           // Mixer channels; 0 is the rotor
+    static constexpr int QUEUE_SIZE = 256;      // Triggers in flight; a power of two
+    static constexpr int FREQUENCY = 48000;
+    static constexpr int BUFFER_FRAMES = 512;   // About 11 ms at 48 kHz
+
+private:
+    enum class Command : Uint8 {
+        PLAY,
+        ROTOR_START,
+        ROTOR_STOP,
+        ROTOR_LEVEL,
+        QUIT
+    };
+    
+    struct Trigger {
+        Uint64 queuedAt;
+        Command command;
+        Sound sound;
+        Uint8 volume;       // 0-128
+        Sint8 pan;          // -127 (left) to 127 (right)
+    };
+    
+    struct Voice {
+        Sound sound;
+        Uint64 startedAt;
+    };
+    
+    bool opened;
+    int frequency;
+    int channels;
+    double counterFrequency;
+    
+    std::vector<Sint16> samples[static_cast<int>(Sound::COUNT)];
+    Mix_Chunk* chunks[static_cast<int>(Sound::COUNT)];
+    
+    // The ring: head is written only by the game thread, tail only by the
+    // dispatcher
+    Trigger queue[QUEUE_SIZE];
+    std::atomic<Uint32> queueHead;
+    std::atomic<Uint32> queueTail;
+    SDL_sem* wake;
+    std::thread dispatcher;
+    
+    // Game thread state
+    bool rotorRunning;
+    bool rotorThrust;
+    Uint64 triggers;
+    Uint64 queueFull;
+    
+    // Dispatcher state
+    Voice voices[VOICES];
+    Uint64 played;
+    Uint64 merged;
+    Uint64 stolen;
+    Uint64 refused;
+    int peakVoices;
+    Uint64 latencySum;
+    Uint64 worstLatency;
+    
+    void synthesize();
+    void push(Command command, Sound sound, float volume, float pan);
+    void run();
+    void dispatch(Sound sound, float volume, float pan, Uint64 queuedAt);
+    int pickVoice(Sound sound);
+
+public:
+    AudioEngine();
+    ~AudioEngine();
+    
+    AudioEngine(const AudioEngine&) = delete;
+    AudioEngine& operator=(const AudioEngine&) = delete;
+    
+    // Opens the audio device, synthesizes the samples and starts the
+    // dispatcher. False if there is no usable audio device.
+    bool init();
+    void shutdown();
+    
+    // Game thread only; never blocks. Volume 0-1, pan -1 (left) to 1 (right).
+    // A trigger is dropped if the ring is full.
+    void play(Sound sound, float volume = 1.0f, float pan = 0.0f);
+    
+    // Run the rotor loop, louder under thrust. Only changes are queued.
+    void setRotor(bool running, bool thrust);
+    
+    // Call after shutdown(), once the dispatcher has stopped
+    void printReport(FILE* out) const;
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <SDL2/SDL.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class World;
+
+// A canned stretch of play for timing whole frames: what the world spawns,
+// what is set off in it and how the player flies. Everything is derived from
+// the seed and the tick, so a scenario plays out the same in every build
+// that doesn't change the simulation.
+struct Scenario {
+    const char* name;
+    const char* description;
+    int seconds;                // Game time, 60 frames per second
+    int enemyInterval;          // Ticks between spawns, 0 for none
+    int obstacleInterval;
+    int explosionInterval;      // Ticks between scripted explosions, 0 for none
+    int explosionSize;          // Particles in each
+    float hoverHeight;          // Fraction of the screen height the player holds
+    int shootInterval;          // Ticks between trigger pulls, 0 to hold fire
+    
+    static const Scenario* getAll(size_t& count);
+    static const Scenario* find(const char* name);
+    
+    // Set the world up and start a run from seed
+    void start(World& world, unsigned int seed) const;
+    
+    // Input for the next tick; sets off this tick's scripted explosions
+    void drive(World& world, bool& thrust, bool& shoot) const;
+};
+
+// What a frame's time is split into. FRAME is the whole frame.
+enum class BenchPhase : Uint8 {
+    UPDATE,     // Game::update: input, simulation, rewind capture
+    RENDER,     // Game::render: issuing draw calls
+    RASTER,     // Flushing the renderer; where a software renderer fills pixels
+                // (empty before SDL 2.0.10, which draws inside RENDER)
+    PRESENT,
+    FRAME,
+    COUNT
+};
+
+constexpr int BENCH_PHASE_COUNT = static_cast<int>(BenchPhase::COUNT);
+
+const char* getBenchPhaseName(BenchPhase phase);
+
+// Every timed frame of one scenario, in nanoseconds per phase
+struct BenchmarkRun {
+    std::string scenario;
+    Uint32 resets;              // Runs that ended and were restarted
+    std::vector<Uint32> samples[BENCH_PHASE_COUNT];
+};
+
+// Distribution of one phase
+struct PhaseSummary {
+    double mean;
+    double p50;
+    double p95;
+    double p99;
+    double max;
+};
+
+// A results file: the raw samples of every scenario, so two files can be
+// tested against each other rather than compared by their averages. Text,
+// one line per phase.
+struct BenchmarkResults {
+    std::string label;          // Free-form, e.g. the commit measured
+    std::string settings;       // Quality tier, render scale and seed
+    std::vector<BenchmarkRun> runs;
+    
+    const BenchmarkRun* find(const std::string& scenario) const;
+    
+    bool save(const char* path) const;
+    bool load(const char* path);
+    
+    void printSummary(FILE* out) const;
+};
+
+// Nearest-rank summary of samples; scratch is reused between calls
+PhaseSummary summarize(const std::vector<Uint32>& samples, std::vector<Uint32>& scratch);
+
+// Two-sided Mann-Whitney U test of whether samples from b tend to be larger
+// or smaller than those from a. Makes no assumption about the shape of
+// either distribution, which for frame times is long-tailed. Normal
+// approximation with a correction for ties; p-value in [0, 1].
+double mannWhitneyP(const std::vector<Uint32>& a, const std::vector<Uint32>& b);
+
+// Print every scenario and phase both files have, baseline against
+// current, flagging a change as significant when its median moves by more
+// than threshold (a fraction) and by at least 10 us, and p < alpha. Returns
+// the number of significant regressions.
+int compareResults(const BenchmarkResults& baseline, const BenchmarkResults& current,
+                   double threshold, double alpha, FILE* out);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef BITMAPFONT_H
+#define BITMAPFONT_H
+
+#include <SDL2/SDL.h>
+#include "RenderBackend.h"
+
+// Glyph placement in the baked atlas (see tools/fontbake.cpp). Offsets are
+// from the pen position at the top of the line.
+struct BakedGlyph {
+    Sint16 x, y, w, h;
+    Sint16 offsetX, offsetY;
+    Sint16 advance;
+};
+
+// One baked size: printable ASCII glyphs sharing the atlas texture
+class BitmapFont {
+private:
+    const BakedGlyph* glyphs;
+    SDL_Texture* texture;
+    int height;
+    
+    friend class FontAtlas;
+    
+public:
+    static constexpr int FIRST_CHAR = 32;
+    static constexpr int GLYPH_COUNT = 95;  // ' ' through '~'
+    
+    BitmapFont();
+    
+    int getHeight() const { return height; }
+    int measure(const char* text) const;
+    
+    // Draws text with its top-left corner at (x, y) as one SDL_RenderCopy
+    // per glyph from the shared texture, which SDL batches together
+    void draw(RenderBackend* renderer, const char* text, int x, int y, SDL_Color color) const;
+};
+
+// The glyph atlas baked into the binary at build time, uploaded as a single
+// texture. No font files are needed at runtime.
+class FontAtlas {
+private:
+    static constexpr int FACE_COUNT = 3;
+    
+    SDL_Texture* texture;
+    BitmapFont fonts[FACE_COUNT];
+    
+public:
+    FontAtlas();
+    ~FontAtlas();
+    
+    FontAtlas(const FontAtlas&) = delete;
+    FontAtlas& operator=(const FontAtlas&) = delete;
+    
+    bool init(SDL_Renderer* renderer);
+    void cleanup();
+    
+    // Baked sizes: 72, 48 and 24 point. Returns nullptr for any other size
+    // or before init().
+    const BitmapFont* getFont(int pointSize) const;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define BULLET_H
 
 #include <SDL2/SDL.h>
+#include "RenderBackend.h"
 
 class Bullet {
 private:
@@ -14,7 +15,7 @@ public:
     Bullet(float startX, float startY);
     
     void update();
-    void render(SDL_Renderer* renderer);
+    void render(RenderBackend* renderer);
     
     // Getters
     SDL_Rect getBounds() const;
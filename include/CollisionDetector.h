@@ -2,12 +2,19 @@
 #define COLLISIONDETECTOR_H
 
 #include <SDL2/SDL.h>
+#include "CollisionMask.h"
 
 class CollisionDetector {
 public:
     // AABB collision detection
     static bool checkCollision(const SDL_Rect& a, const SDL_Rect& b);
     
+    // Pixel-accurate: the boxes first, then the shapes only if they overlap.
+    // Each mask sits at the top-left of its box; a plain box is solid.
+    static bool checkCollision(const SDL_Rect& a, const CollisionMask& maskA,
+                               const SDL_Rect& b, const CollisionMask& maskB);
+    static bool checkCollision(const SDL_Rect& a, const CollisionMask& maskA, const SDL_Rect& b);
+    
     // Point-in-rect collision
     static bool pointInRect(int x, int y, const SDL_Rect& rect);
     
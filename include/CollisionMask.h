@@ -0,0 +1,73 @@
+#ifndef COLLISIONMASK_H
+#define COLLISIONMASK_H
+
+#include <SDL2/SDL.h>
+#include "RenderBackend.h"
+
+// 1-bit shape of an entity within its bounding box, one 64-bit word per row
+// (bit i is column i from the left). Masks are traced once from the same
+// drawing code the sprites are baked from, and are only consulted after the
+// boxes are known to overlap, so testing two shapes is a shift and an AND
+// per shared row.
+class CollisionMask {
+public:
+    static constexpr int MAX_SIZE = 64;
+
+private:
+    Uint64 rows[MAX_SIZE];
+    int width, height;
+
+public:
+    // An empty mask; sizes are clamped to MAX_SIZE
+    CollisionMask(int width = 0, int height = 0);
+    
+    void set(int x, int y);
+    bool test(int x, int y) const;
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    
+    // Whether this mask, placed at the top-left of `bounds`, shares a set bit
+    // with `other` placed at `otherBounds`, or has one inside `rect`. Parts
+    // of the boxes outside the masks count as empty.
+    bool overlaps(const SDL_Rect& bounds, const CollisionMask& other, const SDL_Rect& otherBounds) const;
+    bool overlapsRect(const SDL_Rect& bounds, const SDL_Rect& rect) const;
+    
+    // This mask turned `degrees` clockwise about (pivotX, pivotY), as
+    // SDL_RenderCopyEx turns a texture, traced into a width x height mask
+    // whose top-left is at (left, top) in this mask's coordinates. Each bit
+    // takes the source bit under its pixel's center.
+    CollisionMask rotated(double degrees, float pivotX, float pivotY,
+                          int left, int top, int width, int height) const;
+};
+
+// Draws into a mask instead of a target: opaque fills, outlines and lines
+// set bits; translucent ones (alpha below 128, such as shadows) and
+// textures don't. Coordinates are mask columns and rows; anything outside
+// is clipped.
+class MaskRenderBackend : public RenderBackend {
+private:
+    CollisionMask& mask;
+    bool solid;
+    
+    void fillClipped(int x1, int y1, int x2, int y2);
+
+public:
+    explicit MaskRenderBackend(CollisionMask& mask) : mask(mask), solid(true) {}
+    
+    SDL_Renderer* getSDLRenderer() const override { return nullptr; }
+    
+    void setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) override;
+    void setDrawBlendMode(SDL_BlendMode) override {}
+    void clear() override;
+    void fillRect(const SDL_Rect* rect) override;
+    void fillRects(const SDL_Rect* rects, int count) override;
+    void drawRect(const SDL_Rect* rect) override;
+    void drawLine(int x1, int y1, int x2, int y2) override;
+    void copy(SDL_Texture*, const SDL_Rect*, const SDL_Rect*) override {}
+    void copyEx(SDL_Texture*, const SDL_Rect*, const SDL_Rect*,
+                double, const SDL_Point*, SDL_RendererFlip) override {}
+    bool geometry(SDL_Texture*, const SDL_Vertex*, int, const int*, int) override { return false; }
+    void present() override {}
+};
+
+#endif
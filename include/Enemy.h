@@ -2,29 +2,83 @@
 #define ENEMY_H
 
 #include <SDL2/SDL.h>
+#include "RenderBackend.h"
+#include "CollisionMask.h"
+
+class SpriteCache;
 
 enum class EnemyType {
     STATIONARY,
     SINE_WAVE,
-    CHARGING
+    CHARGING,
+    SCRIPTED        // Flies one of the attack patterns below
+};
+
+constexpr int ENEMY_TYPE_COUNT = 4;
+
+// Attack patterns for SCRIPTED enemies. Each is a short program of steps
+// (wait, move, sine path, dive at the player, repeat) in Enemy.cpp.
+enum class EnemyScript : Uint8 {
+    SWOOP,          // Glide in, hover, dive at the player
+    WEAVE,          // Two sine runs of different widths
+    AMBUSH          // Stop short, bob up and down three times, then dive
 };
 
+constexpr int ENEMY_SCRIPT_COUNT = 3;
+
 class Enemy {
 private:
     float x, y;
-    float startY;              // For sine wave pattern
+    float startY;              // Sine centre; for scripts, y where the current step began
     float velocityX;
     int width, height;
     int health;
     bool active;
     EnemyType type;
+    Uint32 id;                 // Spawn sequence number, unique within a run
     float timeAlive;           // For movement patterns
     
+    // Where a SCRIPTED enemy is in its script. Plain values rather than a
+    // coroutine frame, so snapshots can copy enemies as bytes.
+    float startX;              // x where the current step began
+    EnemyScript script;
+    Uint8 step;                // Index of the current step
+    Uint8 repeats;             // Times the current loop has gone back
+    Uint16 stepTicks;          // Ticks into the current step
+    
+    void runScript(float playerY);
+    void nextStep(int index);
+    
 public:
-    Enemy(float startX, float startY, EnemyType enemyType);
+    // Sprite texture size and where the enemy's origin sits in it
+    static constexpr int SPRITE_WIDTH = 40;
+    static constexpr int SPRITE_HEIGHT = 40;
+    static constexpr int SPRITE_ORIGIN_X = 0;
+    static constexpr int SPRITE_ORIGIN_Y = 6;
+    
+    // Collision box size
+    static constexpr int WIDTH = 40;
+    static constexpr int HEIGHT = 30;
+    
+    Enemy(Uint32 id, float startX, float startY, EnemyType enemyType, EnemyScript enemyScript = EnemyScript::SWOOP);
+    
+    // Advance every enemy in an array that holds only the given type. Each
+    // behavior is its own specialization, so the loops carry no per-entity
+    // type switch.
+    template <EnemyType Type>
+    static void updateAll(Enemy* enemies, size_t count, float playerY);
+    
+    // Without shadows, draws the sprite baked without its drop shadow
+    void render(RenderBackend* renderer, const SpriteCache& sprites, bool shadows = true);
+    
+    // Draws the enemy with primitives, origin at (x, y). Used to bake
+    // sprites, and directly if they couldn't be created.
+    static void drawSprite(RenderBackend* renderer, int x, int y, int rotorFrame, bool lights, bool shadow = true);
+    
+    // Solid parts of the sprite within the collision box, both rotor frames,
+    // no shadow. All enemy types share it.
+    static const CollisionMask& getCollisionMask();
     
-    void update(float playerX, float playerY);
-    void render(SDL_Renderer* renderer);
     void takeDamage(int damage);
     
     // Getters
@@ -32,6 +86,16 @@ public:
     bool isActive() const { return active; }
     void deactivate() { active = false; }
     int getHealth() const { return health; }
+    EnemyType getType() const { return type; }
+    Uint32 getId() const { return id; }
+    
+    // Charging, or a scripted enemy in a dive; their warning lights blink
+    bool isAttacking() const;
 };
 
+template <> void Enemy::updateAll<EnemyType::STATIONARY>(Enemy* enemies, size_t count, float playerY);
+template <> void Enemy::updateAll<EnemyType::SINE_WAVE>(Enemy* enemies, size_t count, float playerY);
+template <> void Enemy::updateAll<EnemyType::CHARGING>(Enemy* enemies, size_t count, float playerY);
+template <> void Enemy::updateAll<EnemyType::SCRIPTED>(Enemy* enemies, size_t count, float playerY);
+
 #endif
@@ -0,0 +1,104 @@
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class CaptureFormat {
+    Y4M,        // YUV4MPEG2, 4:2:0 full range; plays in ffplay/mpv as-is
+    RAW_RGB     // Packed 24-bit RGB frames, no header
+};
+
+// What to do with a frame when every buffer is still waiting to be written
+enum class CapturePolicy {
+    DROP,       // Skip the frame; the game never waits on the disk
+    BLOCK       // Wait for a buffer; the video has every frame
+};
+
+// Records rendered frames to a video file. The game thread only reads each
+// frame back into one of a fixed pool of buffers and queues it; a writer
+// thread converts it to the output format and writes it. The pool is
+// allocated when the file is opened, so capturing doesn't allocate per
+// frame, and its size bounds the queue.
+class FrameCapture {
+private:
+    std::string path;
+    FILE* file;
+    CaptureFormat format;
+    CapturePolicy policy;
+    int width, height;
+    int fps;
+    
+    // Pool of ARGB8888 frames. Slots move free -> filled by capture(), then
+    // queued -> written -> free on the writer. The queue is a ring with room
+    // for every slot.
+    std::vector<Uint8> pool;
+    size_t frameBytes;
+    int slotCount;
+    std::vector<int> freeSlots;
+    std::vector<int> queue;
+    int queueHead;
+    int queueCount;
+    
+    // Worker-only conversion output
+    std::vector<Uint8> converted;
+    
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;       // Writer: a frame was queued or stop
+    std::condition_variable slotFreed;  // Game thread, BLOCK policy
+    bool stopping;
+    bool writeFailed;
+    
+    // Statistics; the writer's are guarded by the mutex, readback and
+    // waiting times belong to the game thread
+    double frequency;
+    Uint64 captured;
+    Uint64 dropped;
+    Uint64 written;
+    int deepestQueue;
+    Uint64 readbackTicks;
+    Uint64 worstReadback;
+    Uint64 blockedTicks;
+    Uint64 writeTicks;
+    
+    void run();
+    bool writeFrame(const Uint8* pixels);
+    void convertY4M(const Uint8* pixels);
+    void convertRGB(const Uint8* pixels);
+
+public:
+    FrameCapture();
+    ~FrameCapture();  // Writes anything still queued, then joins
+    
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+    
+    // Create the file and start the writer. bufferCount frames (at least 2)
+    // are allocated up front.
+    bool open(const std::string& path, int width, int height, int fps,
+              CaptureFormat format, CapturePolicy policy, int bufferCount);
+    
+    // Stop accepting frames, write out the queue and close the file
+    void close();
+    
+    bool isOpen() const { return file != nullptr; }
+    
+    // Read the renderer's current target back and queue it. Call after the
+    // frame is drawn and before it's presented.
+    void capture(SDL_Renderer* renderer);
+    
+    // Frames captured, dropped and written, queue depth, and time spent on
+    // the game thread (readback, waiting) and on the writer
+    void printReport(FILE* out);
+    
+    // Y4M for a .y4m path, raw RGB otherwise
+    static CaptureFormat formatForPath(const std::string& path);
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <SDL2/SDL.h>
+#include <cstdio>
+
+// Holds the game loop to a fixed frame rate using the high-resolution
+// performance counter. Deadlines are absolute (start + n * period) so
+// rounding never accumulates; each wait sleeps while the deadline is far
+// off, then spins for the last stretch, which lands within ~100 us where
+// SDL_Delay alone can be a millisecond or more late.
+//
+// When vsync already paces presents at the target rate, present returns at
+// the vblank and the pacer instead latches late: it sleeps until just enough
+// time is left to run one frame's work before the next vblank, so input is
+// sampled close to when its frame is shown rather than a whole period early.
+// Present-to-present intervals go into a histogram for percentiles.
+class FramePacer {
+private:
+    static constexpr int BUCKET_US = 50;        // Histogram resolution
+    static constexpr int BUCKET_COUNT = 1000;   // Up to 50 ms; last bucket is overflow
+    
+    double frequency;           // Counter ticks per second
+    Uint64 period;              // Counter ticks per frame
+    Uint64 deadline;
+    Uint64 lastFrame;
+    bool started;
+    bool vsyncLocked;
+    bool pumpEvents;
+    
+    // Estimated SDL_Delay overshoot; the spin starts this far before the deadline
+    Uint64 spinMargin;
+    
+    // Decaying maximum of the update+render time; vsync waits leave this
+    // much (plus a safety margin) before the next vblank
+    Uint64 workEstimate;
+    
+    // Statistics
+    Uint32 histogram[BUCKET_COUNT];
+    Uint64 frames;
+    Uint64 missed;
+    Uint64 worstInterval;
+    
+    Uint64 toTicks(double microseconds) const;
+    double toMicroseconds(Uint64 ticks) const;
+    double percentile(double p) const;
+    Uint64 sleepUntil(Uint64 target, Uint64 now);
+    
+public:
+    explicit FramePacer(int targetFps);
+    
+    // With vsync on and a display refresh within 1 Hz of the target, present
+    // already blocks for the right time and the pacer doesn't wait
+    void setVsync(bool enabled, int refreshRate);
+    bool isVsyncLocked() const { return vsyncLocked; }
+    
+    // Report how long the frame's update and render took, before presenting
+    void recordWork(Uint64 ticks);
+    
+    // Pump SDL events about once a millisecond while waiting, so input event
+    // watchers see events when they arrive instead of at the next frame
+    void setPumpEvents(bool enabled) { pumpEvents = enabled; }
+    
+    // Call once per frame right after presenting. Returns once it's time to
+    // sample input for the next frame.
+    void waitForNextFrame();
+    
+    // Forget the schedule, e.g. after the loop was idle, so the gap isn't
+    // counted as a missed frame
+    void restart() { started = false; }
+    
+    void clearStats();
+    void printReport(FILE* out) const;
+};
+
+#endif
@@ -2,14 +2,22 @@
 #define GAME_H
 
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
-#include <vector>
-#include "Helicopter.h"
-#include "Bullet.h"
-#include "Enemy.h"
-#include "Obstacle.h"
-#include "Particle.h"
-#include "Terrain.h"
+#include "World.h"
+#include "RewindBuffer.h"
+#include "ScoreWriter.h"
+#include "RunLog.h"
+#include "BitmapFont.h"
+#include "FramePacer.h"
+#include "QualityGovernor.h"
+#include "InputLatency.h"
+#include "RenderBackend.h"
+#include "AllocTracker.h"
+#include "FrameCapture.h"
+#include "Metrics.h"
+#include "AudioEngine.h"
+#include "Offscreen.h"
+#include "Benchmark.h"
+#include <string>
 
 enum class GameState {
     MENU,
@@ -21,61 +29,190 @@ enum class GameState {
 class Game {
 private:
     SDL_Window* window;
-    SDL_Renderer* renderer;
+    SDL_Renderer* sdlRenderer;
+    
+    // Without a window, drawing goes to a software renderer (benchmarks)
+    OffscreenRenderer* offscreen;
+    bool offscreenEnabled;
+    
+    // Where all drawing goes: the SDL backend, or a counter wrapping it
+    RenderBackend* renderer;
+    SDLRenderBackend* sdlBackend;
+    CountingRenderBackend* renderCounter;
+    bool renderStatsEnabled;
+    
     bool running;
     GameState state;
     
-    // Game entities
-    Helicopter* player;
-    Terrain* terrain;
-    std::vector<Bullet*> bullets;
-    std::vector<Enemy*> enemies;
-    std::vector<Obstacle*> obstacles;
-    std::vector<Particle*> particles;
+    // Simulation (player, terrain, entities, score)
+    World* world;
+    
+    // Recent history for rewinding after a crash or while paused
+    RewindBuffer* rewindBuffer;
     
     // Game stats
-    int score;
     int highScore;
-    float distanceTraveled;
-    int enemiesKilled;
+    ScoreWriter* scoreWriter;  // Saves highScore off the game thread
     
-    // Spawn timers
-    int enemySpawnTimer;
-    int obstacleSpawnTimer;
+    // Run history: the current run is appended to the log once the player
+    // leaves its game over screen (rewinding in between continues the run)
+    RunLogWriter* runLog;
+    RunRecord currentRun;
+    Uint64 runFrameTimeSum;  // Microseconds, for the average
+    Uint32 runStartTime;
+    bool runActive;
     
     // Input flags
     bool thrustPressed;  // For tap-based thrust control
     
-    // Fonts
-    TTF_Font* fontLarge;
-    TTF_Font* fontMedium;
-    TTF_Font* fontSmall;
+    // Fonts, baked into the binary at build time
+    FontAtlas* fontAtlas;
+    const BitmapFont* fontLarge;
+    const BitmapFont* fontMedium;
+    const BitmapFont* fontSmall;
+    
+    // Last static screen drawn, reused while nothing changes
+    SDL_Texture* screenCache;
+    GameState cachedState;
+    bool screenDirty;
+    bool promptShown;
+    
+    // Paces PLAYING frames; its interval statistics are printed at exit
+    // with --frame-stats
+    FramePacer pacer;
+    bool frameStatsEnabled;
+    
+    // Lowers visual effects, then the world's render resolution, while
+    // frames run close to the budget
+    QualityGovernor quality;
+    
+    // Below 100%, PLAYING frames draw the world into the top-left of this
+    // full-size target at the reduced size and stretch it over the window
+    SDL_Texture* sceneTarget;
+    int renderScale;            // Percent
+    
+    // Optional input-to-present latency instrumentation (--latency)
+    InputLatency* inputLatency;
+    bool latencyEnabled;
+    bool latencyPerFrame;
+    
+    // Allocation report (--alloc-stats) and the no-allocation check on
+    // update() once play has warmed up (--alloc-check); both need a build
+    // with ALLOC_TRACKING=1
+    bool allocStatsEnabled;
+    bool allocCheckEnabled;
+    Uint32 ticksPlayed;
+    
+    // Optional recording of PLAYING frames to a video file (--capture)
+    FrameCapture* frameCapture;
+    std::string capturePath;
+    CapturePolicy capturePolicy;
+    
+    // Optional shared-memory metrics for external monitoring (--metrics)
+    MetricsPublisher* metrics;
+    std::string metricsName;
+    
+    // Sound effects; off with --no-audio, or when no device opens
+    AudioEngine* audio;
+    bool audioEnabled;
+    bool audioStatsEnabled;
+    
+    // Plays instead of the keyboard while benchmarking
+    const Scenario* scenario;
     
     // Screen dimensions
     static constexpr int SCREEN_WIDTH = 1280;
     static constexpr int SCREEN_HEIGHT = 720;
     static constexpr int FPS = 60;
     
+    // Rewind history: 10 seconds within 2 MB, keyframe every second
+    static constexpr int REWIND_SECONDS = 10;
+    static constexpr size_t REWIND_BUDGET = 2 * 1024 * 1024;
+    static constexpr int REWIND_STEP = 10;  // ticks per LEFT press
+    
+    // Ticks of play before update() must stop allocating
+    static constexpr Uint32 ALLOC_WARMUP_TICKS = 2 * FPS;
+    
+    // Frames the capture writer can fall behind by (about 30 MB at 1280x720)
+    static constexpr int CAPTURE_BUFFERS = 8;
+    
+    // Idle screens: start prompt blink (on for 2/3 of a second) and the
+    // longest the loop sleeps without events
+    static constexpr Uint32 BLINK_PERIOD_MS = 1000;
+    static constexpr Uint32 BLINK_ON_MS = 667;
+    static constexpr Uint32 IDLE_WAKEUP_MS = 500;
+    
     // Helper methods
     void handleEvents();
+    void handleEvent(const SDL_Event& event);
     void update();
     void render();
-    void spawnEnemy();
-    void spawnObstacle();
-    void createExplosion(float x, float y, int count);
-    void cleanupEntities();
+    void renderScene();
+    void renderWorld();
+    void runIdle();
+    bool startPromptVisible() const;
     void resetGame();
+    void rewindGame();
+    void finishRun();
+    void recordFrameTime(Uint32 microseconds);
+    void publishMetrics();
+    void playSounds(bool thrust);
     void renderMenu();
     void renderHUD();
     void renderGameOver();
     void loadHighScore();
     void saveHighScore();
-    void renderText(const char* text, int x, int y, TTF_Font* font, SDL_Color color, bool centered = false);
+    void renderText(const char* text, int x, int y, const BitmapFont* font, SDL_Color color, bool centered = false);
     
 public:
     Game();
     ~Game();
     
+    // Count draw calls per subsystem and report them at exit. Call before init().
+    void enableRenderStats();
+    
+    // Report frame interval percentiles, missed deadlines and the quality
+    // steps taken at exit
+    void enableFrameStats();
+    
+    // Measure input-to-present latency and report it at exit, optionally
+    // with a line per frame. Call before init().
+    void enableLatencyReport(bool perFrame);
+    
+    // Report heap allocations per frame and per subsystem at exit, and with
+    // zeroAllocCheck abort on any allocation in update() after warmup. Only
+    // effective when built with ALLOC_TRACKING=1.
+    void enableAllocReport(bool zeroAllocCheck);
+    
+    // Record gameplay frames to path: Y4M for a .y4m name, raw RGB
+    // otherwise. With DROP, frames are skipped while the writer is behind;
+    // with BLOCK, the game waits for it. Call before init().
+    void enableCapture(const std::string& path, CapturePolicy policy);
+    
+    // Publish frame times, entity counts, state and score every frame to a
+    // POSIX shared-memory segment for monitoring agents. Call before init().
+    void enableMetrics(const std::string& segmentName);
+    
+    // Keep effects at one tier, or the world's render resolution at a
+    // percentage of the window's, instead of adapting them to frame times
+    void setFixedQuality(QualityTier tier);
+    void setFixedRenderScale(int percent);
+    
+    // Play without sound, or report on the audio engine at exit. Call
+    // before init().
+    void disableAudio();
+    void enableAudioReport();
+    
+    // Draw into an offscreen software renderer instead of a window, without
+    // sound or the high score and run log files. For benchmarks; call
+    // before init().
+    void enableOffscreen();
+    
+    // Play a scenario from seed, drawing every frame, and record how long
+    // each phase of every frame took. The first warmupFrames are played but
+    // not recorded; runs that end are restarted with the next seed.
+    void runBenchmark(const Scenario& benchScenario, unsigned int seed, int warmupFrames, BenchmarkRun& out);
+    
     bool init();
     void run();
     void cleanup();
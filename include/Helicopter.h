@@ -3,8 +3,11 @@
 
 #include <SDL2/SDL.h>
 #include <vector>
+#include "RenderBackend.h"
+#include "CollisionMask.h"
 
 class Bullet;
+class SpriteCache;
 
 class Helicopter {
 private:
@@ -26,19 +29,53 @@ private:
     static constexpr int SHOOT_DELAY = 15; // frames
     
 public:
+    // Sprite texture size and where the helicopter's origin sits in it
+    static constexpr int SPRITE_WIDTH = 64;
+    static constexpr int SPRITE_HEIGHT = 48;
+    static constexpr int SPRITE_ORIGIN_X = 12;
+    static constexpr int SPRITE_ORIGIN_Y = 8;
+    
+    // The body's center, which the sprite tilts about, from the origin,
+    // and the most it tilts either way in degrees
+    static constexpr int TILT_CENTER_X = 20;
+    static constexpr int TILT_CENTER_Y = 17;
+    static constexpr float MAX_TILT = 30.0f;
+    
+    // Collision box size
+    static constexpr int WIDTH = 50;
+    static constexpr int HEIGHT = 30;
+    
+    // Collision masks cover the box grown by this much on each side, enough
+    // for the box's contents at full tilt
+    static constexpr int MASK_PAD_X = 7;
+    static constexpr int MASK_PAD_Y = 14;
+    
     Helicopter(float startX, float startY);
     
-    void update(bool thrustKey, bool shootKey, std::vector<Bullet*>& bullets);
-    void render(SDL_Renderer* renderer);
+    void update(bool thrustKey, bool shootKey, std::vector<Bullet>& bullets);
+    void render(RenderBackend* renderer, const SpriteCache& sprites);
+    
+    // Draws the helicopter with primitives, unrotated, origin at (x, y).
+    // Used to bake sprites, and directly if they couldn't be created.
+    static void drawSprite(RenderBackend* renderer, int x, int y, int rotorFrame, bool exhaust);
+    
+    // Solid parts of the sprite within the collision box (both rotor frames
+    // and the exhaust, not the shadow), tilted as the sprite is drawn at
+    // `rotation`. Traced once every 5 degrees; place it at getMaskBounds().
+    static const CollisionMask& getCollisionMask(float rotation);
+    
     void takeDamage(int damage);
     void reset(float startX, float startY);
     
     // Getters
     SDL_Rect getBounds() const;
+    SDL_Rect getMaskBounds() const;
     int getHealth() const { return health; }
     bool getIsAlive() const { return isAlive; }
     float getX() const { return x; }
     float getY() const { return y; }
+    float getVelocityY() const { return velocityY; }
+    float getRotation() const { return rotation; }
 };
 
 #endif
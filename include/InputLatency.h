@@ -0,0 +1,67 @@
+#ifndef INPUTLATENCY_H
+#define INPUTLATENCY_H
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstdio>
+
+// Instrumentation for input-to-present latency. An SDL event watch stamps
+// each press or release of a control key with the performance counter as
+// SDL queues it and hands it over through a lock-free single-producer ring
+// (SDL serializes watcher calls, whichever thread pumps events). The game
+// marks the moment it latches input for a frame and the moment that frame
+// is presented; every event latched gets an event-to-present latency.
+class InputLatency {
+private:
+    static constexpr Uint32 QUEUE_SIZE = 256;      // Power of two
+    static constexpr int BUCKET_US = 100;          // Histogram resolution
+    static constexpr int BUCKET_COUNT = 1000;      // Up to 100 ms; last bucket is overflow
+    
+    // Ring written by the event watch, read by the game loop
+    Uint64 queue[QUEUE_SIZE];
+    std::atomic<Uint32> head;    // Next slot to write
+    std::atomic<Uint32> tail;    // Next slot to read
+    std::atomic<Uint32> dropped;
+    
+    // Events before this index were latched into the frame being drawn
+    Uint32 latchEnd;
+    
+    double frequency;
+    bool watching;
+    bool perFrame;
+    Uint64 inputFrames;     // Frames that latched at least one event
+    
+    // Statistics
+    Uint32 histogram[BUCKET_COUNT];
+    Uint64 samples;
+    Uint64 worst;
+    double sumUs;
+    
+    static int onEvent(void* userdata, SDL_Event* event);
+    double percentile(double p) const;
+    
+public:
+    InputLatency();
+    ~InputLatency();
+    
+    InputLatency(const InputLatency&) = delete;
+    InputLatency& operator=(const InputLatency&) = delete;
+    
+    // Install the event watch. With perFrameLog, every frame that latched
+    // input prints a line to stdout.
+    void start(bool perFrameLog);
+    void stop();
+    
+    // Drop queued events, e.g. ones that arrived while the loop was idle
+    void discard();
+    
+    // Call right after sampling input for a frame
+    void latched();
+    
+    // Call right after SDL_RenderPresent returns for that frame
+    void presented();
+    
+    void printReport(FILE* out) const;
+};
+
+#endif
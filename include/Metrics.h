@@ -0,0 +1,115 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <SDL2/SDL.h>
+#include <atomic>
+
+// Values published for monitoring. Plain data, copied in and out of the
+// shared block as a whole.
+struct MetricsData {
+    Uint64 timestampMs;         // Unix time of the last update
+    Uint64 frames;              // PLAYING frames since start
+    double frameTimeSum;        // Seconds, sum of the intervals counted in `frames`
+    
+    // Present-to-present intervals over the last WINDOW frames, seconds
+    float intervalP50;
+    float intervalP95;
+    float intervalP99;
+    float intervalMax;
+    float workAverage;          // Update + render time, same window
+    float tickRate;             // Simulation ticks per second, same window
+    
+    Uint32 state;               // GameState
+    Sint32 score;
+    Sint32 highScore;
+    Uint32 tick;                // Ticks into the current run
+    Uint32 bullets;
+    Uint32 enemies;
+    Uint32 obstacles;
+    Uint32 particles;
+};
+
+// Layout of the shared-memory segment. The sequence number is odd while the
+// game is writing; readers copy the data and retry if it was odd or changed.
+struct MetricsBlock {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 pid;
+    std::atomic<Uint32> sequence;
+    MetricsData data;
+};
+
+static_assert(std::atomic<Uint32>::is_always_lock_free, "the sequence must work across processes");
+
+constexpr Uint32 METRICS_MAGIC = 0x54454D48;   // "HMET"
+constexpr Uint32 METRICS_VERSION = 1;
+constexpr const char* METRICS_DEFAULT_NAME = "/helicopter_game.metrics";
+
+// Owns the segment and updates it once per frame. Writing never waits on
+// readers: a seqlock has a single writer and readers only ever retry.
+class MetricsPublisher {
+public:
+    static constexpr int WINDOW = 120;  // Frames of history for percentiles
+
+private:
+    MetricsBlock* block;
+    char name[64];
+    double frequency;
+    
+    // Recent frames, as counter ticks
+    Uint64 intervals[WINDOW];
+    Uint64 work[WINDOW];
+    Uint32 ticks[WINDOW];       // Simulation ticks advanced in each frame
+    int next;
+    int filled;
+    Uint64 lastFrame;
+    Uint32 lastTick;
+    
+    Uint64 frames;
+    double frameTimeSum;
+    MetricsData current;
+
+public:
+    MetricsPublisher();
+    ~MetricsPublisher();  // Removes the segment
+    
+    MetricsPublisher(const MetricsPublisher&) = delete;
+    MetricsPublisher& operator=(const MetricsPublisher&) = delete;
+    
+    // Create (or take over) the named POSIX shared-memory segment
+    bool open(const char* segmentName);
+    void close();
+    bool isOpen() const { return block != nullptr; }
+    
+    // Count a PLAYING frame, right after it was presented
+    void recordFrame(Uint64 workTicks, Uint32 worldTick);
+    
+    // Forget the last frame's time, after the loop was idle
+    void restart() { lastFrame = 0; }
+    
+    // Fill in the game's own values, then publish everything
+    void publish(Uint32 state, Sint32 score, Sint32 highScore, Uint32 tick,
+                 Uint32 bullets, Uint32 enemies, Uint32 obstacles, Uint32 particles);
+};
+
+// Read-only view of another process's segment
+class MetricsReader {
+private:
+    const MetricsBlock* block;
+
+public:
+    MetricsReader();
+    ~MetricsReader();
+    
+    MetricsReader(const MetricsReader&) = delete;
+    MetricsReader& operator=(const MetricsReader&) = delete;
+    
+    bool open(const char* segmentName);
+    void close();
+    
+    // A consistent copy of the data; false if none could be taken (the
+    // writer kept it busy for every attempt)
+    bool read(MetricsData& out, Uint32& pid) const;
+};
+
+#endif
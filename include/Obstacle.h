@@ -2,6 +2,9 @@
 #define OBSTACLE_H
 
 #include <SDL2/SDL.h>
+#include "RenderBackend.h"
+
+class SpriteCache;
 
 enum class ObstacleType {
     STATIC_BARRIER,
@@ -9,6 +12,8 @@ enum class ObstacleType {
     ROTATING
 };
 
+constexpr int OBSTACLE_TYPE_COUNT = 3;
+
 class Obstacle {
 private:
     float x, y;
@@ -16,20 +21,41 @@ private:
     int width, height;
     bool active;
     ObstacleType type;
+    Uint32 id;                 // Spawn sequence number, unique within a run
     float timeAlive;
     float velocityX;
     float velocityY;
     
 public:
-    Obstacle(float startX, float startY, int w, int h, ObstacleType obstacleType);
+    // Sprites extend past the bounds for the glow (1 px) and shadow (2 px)
+    static constexpr int SPRITE_ORIGIN = 1;
+    static constexpr int SPRITE_PADDING = 3;
+    
+    Obstacle(Uint32 id, float startX, float startY, int w, int h, ObstacleType obstacleType);
     
-    void update();
-    void render(SDL_Renderer* renderer);
+    // Advance every obstacle in an array that holds only the given type,
+    // one specialization per behavior
+    template <ObstacleType Type>
+    static void updateAll(Obstacle* obstacles, size_t count);
+    
+    // Without shadows, draws the sprite baked without its drop shadow
+    void render(RenderBackend* renderer, SpriteCache& sprites, bool shadows = true);
+    
+    // Draws the obstacle with primitives, unrotated, top-left at (x, y).
+    // Used to bake sprites, and directly if they couldn't be created.
+    static void drawSprite(RenderBackend* renderer, int x, int y, int width, int height, ObstacleType type,
+                           bool shadow = true);
     
     // Getters
     SDL_Rect getBounds() const;
     bool isActive() const { return active; }
     void deactivate() { active = false; }
+    ObstacleType getType() const { return type; }
+    Uint32 getId() const { return id; }
 };
 
+template <> void Obstacle::updateAll<ObstacleType::STATIC_BARRIER>(Obstacle* obstacles, size_t count);
+template <> void Obstacle::updateAll<ObstacleType::MOVING_VERTICAL>(Obstacle* obstacles, size_t count);
+template <> void Obstacle::updateAll<ObstacleType::ROTATING>(Obstacle* obstacles, size_t count);
+
 #endif
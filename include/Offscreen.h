@@ -0,0 +1,38 @@
+#ifndef OFFSCREEN_H
+#define OFFSCREEN_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Software renderer that draws into an in-memory surface instead of a window.
+// Works without a display. Downscaling is applied as a render scale, so the
+// pipeline rasterizes directly at the reduced size and callers keep drawing in
+// full-resolution logical coordinates.
+class OffscreenRenderer {
+private:
+    SDL_Surface* surface;      // XRGB8888 framebuffer at output resolution
+    SDL_Renderer* renderer;    // Software renderer targeting surface
+    bool grayscale;
+    std::vector<Uint8> grayPixels;  // Luma output, sized once in init()
+
+public:
+    OffscreenRenderer();
+    ~OffscreenRenderer();
+    
+    OffscreenRenderer(const OffscreenRenderer&) = delete;
+    OffscreenRenderer& operator=(const OffscreenRenderer&) = delete;
+    
+    // logicalWidth/Height is the coordinate space callers draw in; the
+    // framebuffer is that size divided by downscale (1 = full resolution).
+    bool init(int logicalWidth, int logicalHeight, int downscale, bool gray);
+    void cleanup();
+    
+    SDL_Renderer* getRenderer() const { return renderer; }
+    
+    // Finish the frame and return a pointer to its pixels. Color frames point
+    // straight at the framebuffer; grayscale frames at an internal buffer.
+    // Valid until the next frame is drawn.
+    const Uint8* getFrame(int& width, int& height, int& pitch, int& channels);
+};
+
+#endif
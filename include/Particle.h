@@ -2,6 +2,8 @@
 #define PARTICLE_H
 
 #include <SDL2/SDL.h>
+#include <vector>
+#include "RenderBackend.h"
 
 class Particle {
 private:
@@ -17,9 +19,38 @@ public:
     Particle(float startX, float startY, float velX, float velY, Uint8 red, Uint8 green, Uint8 blue);
     
     void update();
-    void render(SDL_Renderer* renderer);
     
     bool isActive() const { return active; }
+    SDL_Rect getRect() const;
+    SDL_Color getColor() const;  // Alpha fades out over the lifetime
+    
+    // A number fixed for the particle's lifetime (from its color and
+    // horizontal velocity, which never change), for picking a stable
+    // subset to draw
+    Uint32 getVariant() const;
+};
+
+// Draws all live particles as one indexed triangle list (two triangles per
+// particle, color and alpha per vertex) in a single geometry call, with
+// blending on so the fade-out shows. Where geometry isn't available, runs of
+// same-colored particles go out as one rect batch each. Buffers are sized
+// once for the particle cap; the index pattern never changes. At lower
+// quality only the particles whose variant falls on the stride are drawn,
+// so the same ones stay visible from frame to frame.
+class ParticleBatch {
+private:
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    std::vector<SDL_Rect> rects;
+    
+    void drawRects(RenderBackend* renderer, const std::vector<Particle>& particles, int stride, size_t cap);
+    
+public:
+    explicit ParticleBatch(size_t capacity);
+    
+    // Draws about 1 in stride live particles, at most cap of them
+    void draw(RenderBackend* renderer, const std::vector<Particle>& particles, int stride = 1,
+              size_t cap = static_cast<size_t>(-1));
 };
 
 #endif
@@ -0,0 +1,81 @@
+#ifndef QUALITYGOVERNOR_H
+#define QUALITYGOVERNOR_H
+
+#include <SDL2/SDL.h>
+#include <cstdio>
+#include "RenderQuality.h"
+
+// Picks the effects tier and the world's render resolution from how long
+// frames take to update and render. The average over the last WINDOW
+// frames is compared with the frame budget: above STEP_DOWN of it quality
+// drops one step at once, and it only rises again after the average has
+// stayed below STEP_UP for a while. The gap between the two thresholds and
+// the wait keep it from flapping; a step that turns out too heavy soon
+// after rising makes the next wait twice as long. Samples from before a
+// change are discarded, so every decision is made on frames drawn at the
+// current settings.
+//
+// Going down, the effects tier drops first, then the resolution in
+// SCALE_STEP steps to MIN_SCALE; going up retraces the same path. Either
+// can be held fixed, and the other still adapts.
+class QualityGovernor {
+public:
+    static constexpr int MIN_SCALE = 50;       // Percent of full resolution
+    static constexpr int SCALE_STEP = 10;
+
+private:
+    static constexpr int WINDOW = 30;
+    static constexpr double STEP_DOWN = 0.75;
+    static constexpr double STEP_UP = 0.40;
+    static constexpr int MIN_UP_WAIT_SECONDS = 3;
+    static constexpr int MAX_UP_WAIT_SECONDS = 48;
+    
+    int fps;
+    Uint64 budget;              // Counter ticks per frame
+    QualityTier tier;
+    int scale;                  // Percent
+    bool tierFixed;
+    bool scaleFixed;
+    
+    Uint64 samples[WINDOW];
+    Uint64 sampleSum;
+    int next;
+    int filled;
+    
+    int calmFrames;             // Consecutive frames with the average below STEP_UP
+    int upWait;                 // Frames of calm needed to step up
+    int sinceUp;                // Frames since the last step up
+    
+    // Statistics
+    Uint64 framesAt[static_cast<int>(QualityTier::COUNT)];
+    Uint64 scaleSum;            // Sum of the scale over all frames
+    int lowestScale;
+    Uint32 stepsDown;
+    Uint32 stepsUp;
+    
+    bool stepDown();
+    bool stepUp();
+
+public:
+    explicit QualityGovernor(int targetFps);
+    
+    // Hold the effects tier or the resolution instead of adapting it
+    void setFixedTier(QualityTier fixedTier);
+    void setFixedScale(int percent);
+    bool isAutomatic() const { return !tierFixed || !scaleFixed; }
+    
+    // Report a PLAYING frame's update and render time. Returns true when
+    // the tier or the scale changed.
+    bool recordWork(Uint64 ticks);
+    
+    // Forget recent frames, e.g. after the loop was idle
+    void restart();
+    
+    QualityTier getTier() const { return tier; }
+    const RenderQuality& getQuality() const { return RenderQuality::forTier(tier); }
+    int getScale() const { return scale; }
+    
+    void printReport(FILE* out) const;
+};
+
+#endif
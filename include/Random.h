@@ -0,0 +1,32 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// Small deterministic PRNG (xorshift32) so every World owns its own random
+// stream and can be reseeded independently of the C library rand() state.
+class Random {
+private:
+    uint32_t state;
+
+public:
+    explicit Random(uint32_t seed = 1) { reseed(seed); }
+    
+    void reseed(uint32_t seed) {
+        // xorshift must never hold a zero state
+        state = seed ? seed : 0x9E3779B9u;
+    }
+    
+    // Non-negative value in [0, 2^31), used like rand()
+    int next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<int>(state >> 1);
+    }
+    
+    uint32_t getState() const { return state; }
+    void setState(uint32_t s) { state = s; }
+};
+
+#endif
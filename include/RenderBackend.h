@@ -0,0 +1,192 @@
+#ifndef RENDERBACKEND_H
+#define RENDERBACKEND_H
+
+#include <SDL2/SDL.h>
+#include <cstdio>
+
+// SDL before 2.0.18 has no geometry API (and before 2.0.10 no float
+// points). Declare the vertex layout anyway so batching code builds;
+// SDLRenderBackend::geometry then reports that it can't draw.
+#if !SDL_VERSION_ATLEAST(2, 0, 10)
+typedef struct SDL_FPoint {
+    float x;
+    float y;
+} SDL_FPoint;
+#endif
+
+#if !SDL_VERSION_ATLEAST(2, 0, 18)
+typedef struct SDL_Vertex {
+    SDL_FPoint position;
+    SDL_Color color;
+    SDL_FPoint tex_coord;
+} SDL_Vertex;
+#endif
+
+// Parts of a frame that draw cost is attributed to
+enum class RenderSection : Uint8 {
+    OTHER,
+    SKY,
+    TERRAIN,
+    OBSTACLES,
+    ENEMIES,
+    BULLETS,
+    PARTICLES,
+    PLAYER,
+    HUD,
+    SPRITES,    // Baking sprite textures
+    COUNT
+};
+
+// Thin drawing interface the render code goes through instead of calling
+// SDL_Render* directly, so the same frame can be drawn for real, thrown
+// away, or counted. Calls mirror their SDL counterparts.
+//
+// Textures are still created through SDL: getSDLRenderer() returns nullptr
+// when no SDL renderer is behind the backend, and texture caches then stay
+// empty so callers draw with primitives.
+class RenderBackend {
+public:
+    virtual ~RenderBackend() {}
+    
+    virtual SDL_Renderer* getSDLRenderer() const = 0;
+    
+    // Attribute the following calls to a part of the frame
+    virtual void setSection(RenderSection section) { (void)section; }
+    
+    virtual void setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) = 0;
+    virtual void setDrawBlendMode(SDL_BlendMode mode) = 0;
+    virtual void clear() = 0;
+    virtual void fillRect(const SDL_Rect* rect) = 0;
+    virtual void fillRects(const SDL_Rect* rects, int count) = 0;
+    virtual void drawRect(const SDL_Rect* rect) = 0;
+    virtual void drawLine(int x1, int y1, int x2, int y2) = 0;
+    virtual void copy(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest) = 0;
+    virtual void copyEx(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest,
+                        double angle, const SDL_Point* center, SDL_RendererFlip flip) = 0;
+    
+    // Indexed triangles with per-vertex color. Returns false if the SDL in
+    // use can't draw geometry (before 2.0.18); callers then fall back to
+    // rect fills.
+    virtual bool geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount,
+                          const int* indices, int indexCount) = 0;
+    
+    virtual void present() = 0;
+};
+
+// Forwards to an SDL_Renderer it doesn't own
+class SDLRenderBackend : public RenderBackend {
+private:
+    SDL_Renderer* renderer;
+
+public:
+    explicit SDLRenderBackend(SDL_Renderer* renderer) : renderer(renderer) {}
+    
+    SDL_Renderer* getSDLRenderer() const override { return renderer; }
+    
+    void setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) override;
+    void setDrawBlendMode(SDL_BlendMode mode) override;
+    void clear() override;
+    void fillRect(const SDL_Rect* rect) override;
+    void fillRects(const SDL_Rect* rects, int count) override;
+    void drawRect(const SDL_Rect* rect) override;
+    void drawLine(int x1, int y1, int x2, int y2) override;
+    void copy(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest) override;
+    void copyEx(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest,
+                double angle, const SDL_Point* center, SDL_RendererFlip flip) override;
+    bool geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount,
+                  const int* indices, int indexCount) override;
+    void present() override;
+};
+
+// Discards everything; for running the render code without a display
+class NullRenderBackend : public RenderBackend {
+public:
+    SDL_Renderer* getSDLRenderer() const override { return nullptr; }
+    
+    void setDrawColor(Uint8, Uint8, Uint8, Uint8) override {}
+    void setDrawBlendMode(SDL_BlendMode) override {}
+    void clear() override {}
+    void fillRect(const SDL_Rect*) override {}
+    void fillRects(const SDL_Rect*, int) override {}
+    void drawRect(const SDL_Rect*) override {}
+    void drawLine(int, int, int, int) override {}
+    void copy(SDL_Texture*, const SDL_Rect*, const SDL_Rect*) override {}
+    void copyEx(SDL_Texture*, const SDL_Rect*, const SDL_Rect*,
+                double, const SDL_Point*, SDL_RendererFlip) override {}
+    bool geometry(SDL_Texture*, const SDL_Vertex*, int, const int*, int) override { return true; }
+    void present() override {}
+};
+
+// What was asked of a backend over some span of calls
+struct RenderCounts {
+    Uint64 drawCalls;       // Calls that draw anything
+    Uint64 colorChanges;    // Draw color or blend mode actually changed
+    Uint64 primitives;      // Rects, lines, textured quads and triangles
+    Uint64 pixels;          // Area covered, clipped to the target
+    
+    void add(const RenderCounts& other);
+};
+
+// Tallies calls per section, then forwards them to another backend (the
+// null one for headless measurement, or a real one to profile a live
+// session). A frame ends at present().
+class CountingRenderBackend : public RenderBackend {
+private:
+    static constexpr int SECTION_COUNT = static_cast<int>(RenderSection::COUNT);
+    
+    RenderBackend* inner;
+    int targetWidth;
+    int targetHeight;
+    RenderSection section;
+    
+    // Last state set, to tell real changes from redundant ones
+    Uint32 color;
+    SDL_BlendMode blendMode;
+    bool stateKnown;
+    
+    RenderCounts current[SECTION_COUNT];
+    RenderCounts previous[SECTION_COUNT];
+    RenderCounts totals[SECTION_COUNT];
+    Uint64 frames;
+    Uint64 worstDrawCalls;
+    
+    RenderCounts& counts() { return current[static_cast<int>(section)]; }
+    Uint64 clippedArea(const SDL_Rect* rect) const;
+    void countDraw(Uint64 primitives, Uint64 pixels);
+
+public:
+    // The target size is used to clip areas and for null (whole target) rects
+    CountingRenderBackend(RenderBackend* inner, int targetWidth, int targetHeight);
+    
+    SDL_Renderer* getSDLRenderer() const override { return inner->getSDLRenderer(); }
+    void setSection(RenderSection next) override;
+    
+    void setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) override;
+    void setDrawBlendMode(SDL_BlendMode mode) override;
+    void clear() override;
+    void fillRect(const SDL_Rect* rect) override;
+    void fillRects(const SDL_Rect* rects, int count) override;
+    void drawRect(const SDL_Rect* rect) override;
+    void drawLine(int x1, int y1, int x2, int y2) override;
+    void copy(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest) override;
+    void copyEx(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest,
+                double angle, const SDL_Point* center, SDL_RendererFlip flip) override;
+    bool geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount,
+                  const int* indices, int indexCount) override;
+    void present() override;
+    
+    // Counts for the last presented frame, and totals since the last reset
+    const RenderCounts& getFrame(RenderSection s) const { return previous[static_cast<int>(s)]; }
+    const RenderCounts& getTotal(RenderSection s) const { return totals[static_cast<int>(s)]; }
+    RenderCounts getFrameTotal() const;
+    Uint64 getFrames() const { return frames; }
+    
+    void resetStats();
+    
+    // Per-section averages per frame
+    void printReport(FILE* out) const;
+    
+    static const char* getSectionName(RenderSection s);
+};
+
+#endif
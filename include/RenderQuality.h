@@ -0,0 +1,51 @@
+#ifndef RENDERQUALITY_H
+#define RENDERQUALITY_H
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstring>
+
+// Effects tiers, cheapest first
+enum class QualityTier : Uint8 {
+    LOW,
+    MEDIUM,
+    HIGH,
+    COUNT
+};
+
+// What World::render draws at a tier. Visual only: nothing here feeds back
+// into the simulation, so a run plays out the same at every tier.
+struct RenderQuality {
+    int skyBand;                // Rows per sky gradient step
+    int cloudLayers;            // 0 to 2, nearest layer kept first
+    QualityTier terrainDetail;  // Ground bands drawn (see Terrain::render)
+    bool shadows;               // Drop shadows under enemies and obstacles
+    int particleStride;         // Draw about 1 in this many particles...
+    size_t particleCap;         // ...and at most this many
+    
+    static const RenderQuality& forTier(QualityTier tier) {
+        static const RenderQuality tiers[] = {
+            {4, 0, QualityTier::LOW, false, 4, 128},
+            {1, 1, QualityTier::MEDIUM, false, 2, 256},
+            {1, 2, QualityTier::HIGH, true, 1, 512}
+        };
+        return tiers[static_cast<int>(tier)];
+    }
+};
+
+inline const char* getQualityTierName(QualityTier tier) {
+    static const char* const names[] = {"low", "medium", "high"};
+    return names[static_cast<int>(tier)];
+}
+
+inline bool parseQualityTier(const char* name, QualityTier& tier) {
+    for (int i = 0; i < static_cast<int>(QualityTier::COUNT); i++) {
+        if (std::strcmp(name, getQualityTierName(static_cast<QualityTier>(i))) == 0) {
+            tier = static_cast<QualityTier>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef REWINDBUFFER_H
+#define REWINDBUFFER_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+class World;
+
+// Rolling history of world snapshots for rewinding after a crash or
+// scrubbing back while paused. Every keyframeInterval ticks a full snapshot
+// is stored; the ticks in between are stored as deltas against the previous
+// tick (XOR, then zero-run-length encoded). All memory is allocated up front:
+// when the byte budget or tick limit is reached the oldest keyframe and its
+// deltas are dropped, so capture cost stays constant per tick.
+class RewindBuffer {
+private:
+    struct Record {
+        Uint32 tick;
+        Uint32 offset;     // Position in data
+        Uint32 length;     // Encoded bytes
+        Uint32 rawSize;    // Snapshot bytes after decoding
+        bool keyframe;
+    };
+
+    std::vector<Uint8> data;        // Ring of encoded records
+    std::vector<Record> records;    // Ring of record descriptors
+    size_t firstRecord;
+    size_t recordCount;
+    int keyframeInterval;
+    int sinceKeyframe;
+
+    // Scratch space, sized for the largest snapshot
+    std::vector<Uint8> current;
+    std::vector<Uint8> previous;
+    std::vector<Uint8> xored;
+    std::vector<Uint8> encoded;
+    size_t previousSize;
+
+    Record& recordAt(size_t i) { return records[(firstRecord + i) % records.size()]; }
+    const Record& recordAt(size_t i) const { return records[(firstRecord + i) % records.size()]; }
+    size_t place(size_t length);
+    void evictOldestGroup();
+    bool append(Uint32 tick, const Uint8* bytes, size_t length, size_t rawSize, bool keyframe);
+    void decode(const Record& record, Uint8* state, size_t& stateSize) const;
+
+public:
+    // budgetBytes bounds the encoded history, maxTicks the number of ticks kept
+    RewindBuffer(size_t budgetBytes, int maxTicks, int keyframeInterval, size_t maxSnapshotSize);
+
+    void clear();
+
+    // Record the world's current tick. Ticks already recorded are skipped and
+    // a jump in tick numbers (e.g. a new run) starts a fresh history.
+    void capture(const World& world);
+
+    // Restore the state from `ticks` ticks before the newest record (clamped
+    // to the oldest one kept) and drop everything newer, so capturing resumes
+    // from there. Returns false if there is no history.
+    bool rewind(World& world, unsigned int ticks);
+
+    unsigned int getAvailableTicks() const;
+    size_t getUsedBytes() const;
+};
+
+#endif
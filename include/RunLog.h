@@ -0,0 +1,104 @@
+#ifndef RUNLOG_H
+#define RUNLOG_H
+
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One finished run. Fixed 64-byte records in native byte order are
+// appended to the log as-is, so readers can map the file and index it
+// directly instead of parsing.
+struct RunRecord {
+    Uint64 timestamp;       // Unix time the run ended
+    Uint32 seed;
+    Sint32 score;
+    Sint32 distance;
+    Sint32 enemiesKilled;
+    Uint32 ticks;           // Simulated duration (60 per second)
+    Uint32 wallTimeMs;      // Real time from start to crash, pauses included
+    Uint32 frames;          // Frames played
+    Uint32 frameTimeAvgUs;  // Update + render time per frame
+    Uint32 frameTimeMaxUs;
+    Uint32 slowFrames;      // Frames that took longer than the frame budget
+    Uint16 rewinds;
+    Uint8 deathCause;       // DeathCause
+    Uint8 reserved[13];
+};
+
+static_assert(sizeof(RunRecord) == 64, "run log records are 64 bytes");
+
+// Appends records from a background thread so a finished run never waits on
+// the disk. The file starts with a small header identifying the format.
+class RunLogWriter {
+private:
+    std::string path;
+    
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<RunRecord> pending;
+    bool stopping;
+    
+    void run();
+    bool write(const std::vector<RunRecord>& batch);
+    
+public:
+    explicit RunLogWriter(const std::string& path);
+    ~RunLogWriter();  // Writes anything still queued, then joins
+    
+    RunLogWriter(const RunLogWriter&) = delete;
+    RunLogWriter& operator=(const RunLogWriter&) = delete;
+    
+    void append(const RunRecord& record);
+};
+
+// Fields the reader can rank and summarize
+enum class RunField {
+    SCORE,
+    DISTANCE,
+    ENEMIES_KILLED,
+    TICKS,
+    FRAME_TIME_AVG,
+    FRAME_TIME_MAX
+};
+
+// Read-only memory-mapped view of a run log. A record cut short by a crash
+// mid-append is ignored.
+class RunLogReader {
+private:
+    void* mapping;
+    size_t mappingSize;
+    const RunRecord* records;
+    size_t count;
+    
+public:
+    RunLogReader();
+    ~RunLogReader();
+    
+    RunLogReader(const RunLogReader&) = delete;
+    RunLogReader& operator=(const RunLogReader&) = delete;
+    
+    // Returns false if the file is missing or isn't a run log. An existing
+    // but empty log opens with no records.
+    bool open(const std::string& path);
+    void close();
+    
+    size_t size() const { return count; }
+    const RunRecord& operator[](size_t i) const { return records[i]; }
+    
+    static Sint64 getField(const RunRecord& record, RunField field);
+    
+    // Indices of the n records with the highest value of field, best first.
+    // Ties keep the earlier run ahead.
+    void top(RunField field, size_t n, std::vector<size_t>& out) const;
+    
+    // Nearest-rank percentiles (0-100) of field over all records. scratch
+    // holds one value per record and can be reused between calls.
+    void percentiles(RunField field, const double* ps, size_t n, Sint64* out,
+                     std::vector<Sint64>& scratch) const;
+};
+
+#endif
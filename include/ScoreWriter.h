@@ -0,0 +1,39 @@
+#ifndef SCOREWRITER_H
+#define SCOREWRITER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Persists the high score from a background thread so the game loop never
+// waits on the filesystem. Requests are coalesced: only the latest score is
+// kept, and each write goes to a temp file that is renamed over the real one,
+// so a crash mid-write never leaves a truncated score file.
+class ScoreWriter {
+private:
+    std::string path;
+    std::string tempPath;
+    
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    int pendingScore;
+    bool hasPending;
+    bool stopping;
+    
+    void run();
+    bool write(int score);
+    
+public:
+    explicit ScoreWriter(const std::string& path);
+    ~ScoreWriter();  // Flushes any pending score, then joins
+    
+    ScoreWriter(const ScoreWriter&) = delete;
+    ScoreWriter& operator=(const ScoreWriter&) = delete;
+    
+    // Queue a score to be written. Never blocks on I/O.
+    void submit(int score);
+};
+
+#endif
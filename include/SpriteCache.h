@@ -0,0 +1,58 @@
+#ifndef SPRITECACHE_H
+#define SPRITECACHE_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "Obstacle.h"
+
+// Entity artwork drawn once into textures, so each entity on screen is a
+// single textured quad instead of a dozen or so rect fills. Vehicles are
+// baked up front, one texture per animation frame; obstacles on first use,
+// keyed by (type, width, height) in a bounded least-recently-used cache.
+// Enemies and obstacles come with and without their drop shadow, for the
+// quality tiers that leave shadows out.
+// Textures belong to one renderer: prepare() rebuilds them when called with
+// a different one. If the renderer can't render to textures, or the backend
+// has no SDL renderer behind it, the getters return nullptr and callers fall
+// back to drawing primitives.
+class SpriteCache {
+private:
+    struct ObstacleSprite {
+        Uint32 key;
+        Uint32 lastUsed;
+        SDL_Texture* texture;
+    };
+    
+    RenderBackend* owner;
+    bool targetsSupported;
+    SDL_Texture* helicopter[2][2];  // [rotor frame][exhaust]
+    SDL_Texture* enemy[2][2][2];    // [rotor frame][warning lights][shadow]
+    std::vector<ObstacleSprite> obstacles;
+    Uint32 useClock;
+    
+    template <typename Draw>
+    static SDL_Texture* bake(RenderBackend* renderer, int width, int height, Draw draw);
+    
+public:
+    SpriteCache();
+    ~SpriteCache();
+    
+    SpriteCache(const SpriteCache&) = delete;
+    SpriteCache& operator=(const SpriteCache&) = delete;
+    
+    void prepare(RenderBackend* renderer);
+    
+    // Must be called before the owning renderer is destroyed
+    void cleanup();
+    
+    SDL_Texture* getHelicopter(int rotorFrame, bool exhaust) const { return helicopter[rotorFrame][exhaust]; }
+    SDL_Texture* getEnemy(int rotorFrame, bool lights, bool shadow) const { return enemy[rotorFrame][lights][shadow]; }
+    
+    // Bakes on a miss, evicting the least recently used obstacle when full
+    SDL_Texture* getObstacle(ObstacleType type, int width, int height, bool shadow);
+    
+    // Obstacles come in 3 types x 100 heights; far fewer are on screen
+    static constexpr size_t MAX_OBSTACLE_SPRITES = 32;
+};
+
+#endif
@@ -3,32 +3,71 @@
 
 #include <SDL2/SDL.h>
 #include <vector>
+#include "RenderBackend.h"
+#include "RenderQuality.h"
 
 class Terrain {
-private:
+public:
     struct TerrainPoint {
         int x;
         int groundY;
         int ceilingY;
     };
     
+private:
     std::vector<TerrainPoint> points;
     int scrollSpeed;
     int screenWidth, screenHeight;
     int seed;
     
+    // Render-side mesh, not part of the simulation state. Each point has a
+    // vertex pair (top and bottom edge) per layer; consecutive pairs form a
+    // strip of triangles. Points are addressed by scroll-independent
+    // position (x + scrolled), so scrolling only rewrites x coordinates:
+    // vertices for new points are appended, ones for dropped points are
+    // skipped over, and the buffer is compacted when it runs out of room.
+    // Each detail tier has its own index list over a subset of the layers.
+    static constexpr int MESH_LAYERS = 7;
+    static constexpr int SAMPLE_VERTICES = MESH_LAYERS * 2;
+    static constexpr int POINT_SPACING = 10;
+    static constexpr int DETAIL_TIERS = static_cast<int>(QualityTier::COUNT);
+    
+    std::vector<SDL_Vertex> meshVertices;
+    std::vector<int> meshIndices[DETAIL_TIERS];
+    int meshLayers[DETAIL_TIERS];   // Layers drawn per segment at each tier
+    int scrolled;               // Pixels scrolled since the last reset or restore
+    int meshFirst;              // Position of the first meshed point
+    size_t meshStart;           // Its sample slot in meshVertices
+    size_t meshCount;           // Points meshed
+    bool meshDirty;
+    
     int generateHeight(int x, bool isCeiling);
     float noise(float x);
+    void updateMesh();
+    void writeSample(size_t slot, const TerrainPoint& point);
+    void renderRects(RenderBackend* renderer, QualityTier detail);
     
 public:
     Terrain(int width, int height, int speed);
     
     void update();
-    void render(SDL_Renderer* renderer);
-    void reset();
+    
+    // Low detail draws the ceiling and a plain ground, medium adds the
+    // grass band, high adds the dirt band and the edge lines
+    void render(RenderBackend* renderer, QualityTier detail = QualityTier::HIGH);
+    void reset(int newSeed);
     
     // Collision check
     bool checkCollision(const SDL_Rect& bounds);
+    
+    // Smallest vertical gap between bounds and the ground/ceiling below/above it
+    void getClearance(const SDL_Rect& bounds, int& groundGap, int& ceilingGap) const;
+    
+    // Snapshot support: the scrolling point list plus the generator seed
+    const std::vector<TerrainPoint>& getPoints() const { return points; }
+    int getSeed() const { return seed; }
+    int getPointCapacity() const { return static_cast<int>(points.capacity()); }
+    void restore(int savedSeed, const void* savedPoints, size_t count);
 };
 
 #endif
@@ -0,0 +1,165 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "Helicopter.h"
+#include "Bullet.h"
+#include "Enemy.h"
+#include "Obstacle.h"
+#include "Particle.h"
+#include "Terrain.h"
+#include "Random.h"
+#include "SpriteCache.h"
+#include "RenderQuality.h"
+
+// What ended a run
+enum class DeathCause : Uint8 {
+    NONE,
+    ENEMY,
+    OBSTACLE,
+    TERRAIN
+};
+
+// What happened during the last step, for sound and other feedback. Not
+// part of the simulation state; cleared at the start of every step.
+struct StepEvents {
+    int shots;          // Bullets fired
+    int hits;           // Bullets that damaged an enemy without destroying it
+    int explosions;     // Enemies destroyed, by bullets or by ramming
+    float explosionX;   // Where the last of them was
+    bool crashed;       // The run ended
+};
+
+// The simulation for a single run: player, terrain, entities, score and RNG.
+// Knows nothing about windows, input devices or files, so it can be stepped
+// by the game loop or driven externally through the helisim C API.
+class World {
+private:
+    int width, height;
+    
+    // Entities, stored by value with fixed capacity so stepping and
+    // restoring snapshots never allocate. Enemies and obstacles are kept in
+    // one array per type (index = type ordinal), each in spawn order, and
+    // each array is updated by its type's kernel.
+    Helicopter* player;
+    Terrain* terrain;
+    std::vector<Bullet> bullets;
+    std::vector<Enemy> enemies[ENEMY_TYPE_COUNT];
+    std::vector<Obstacle> obstacles[OBSTACLE_TYPE_COUNT];
+    std::vector<Particle> particles;
+    size_t enemyCapacity;   // All types together; each array reserves this much
+    
+    // Run stats
+    int score;
+    float distanceTraveled;
+    int enemiesKilled;
+    bool gameOver;
+    DeathCause deathCause;
+    unsigned int tick;
+    StepEvents events;
+    
+    // Spawn timers, the ticks between spawns (0 for none) and how many
+    // enemies each enemy spawn brings
+    int enemySpawnTimer;
+    int obstacleSpawnTimer;
+    int enemySpawnInterval;
+    int obstacleSpawnInterval;
+    int enemiesPerSpawn;
+    
+    // Id of the next enemy or obstacle spawned
+    Uint32 nextEntityId;
+    
+    // Parallax cloud scroll
+    int cloudOffset1;
+    int cloudOffset2;
+    
+    Random rng;
+    unsigned int seed;
+    
+    // Render-side only; not part of the simulation state
+    SpriteCache sprites;
+    ParticleBatch particleBatch;
+    RenderQuality quality;
+    
+    void spawnEnemy();
+    void spawnObstacle();
+    void createExplosion(float x, float y, int count);
+    void cleanupEntities();
+    void clearEntities();
+    void endRun(DeathCause cause);
+
+public:
+    // Entity capacities; spawns beyond these are skipped. MAX_ENEMIES is
+    // the default; setEnemyCapacity can raise it up to ENEMY_CAPACITY_LIMIT
+    // (snapshots count enemies in 16 bits).
+    static constexpr size_t MAX_BULLETS = 64;
+    static constexpr size_t MAX_ENEMIES = 64;
+    static constexpr size_t ENEMY_CAPACITY_LIMIT = 65535;
+    static constexpr size_t MAX_OBSTACLES = 64;
+    static constexpr size_t MAX_PARTICLES = 512;
+    
+    World(int screenWidth, int screenHeight);
+    ~World();
+    
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+    
+    // Start a new run; the same seed always produces the same run
+    void reset(unsigned int newSeed);
+    
+    // Advance one tick (1/60 s). Does nothing once the run is over.
+    void step(bool thrust, bool shoot);
+    
+    // Scripted play, e.g. benchmark scenarios. Spawn intervals are in ticks,
+    // 0 for none; the defaults are 120 and 90. Each enemy spawn brings
+    // perSpawn enemies (default 1). These are settings rather than state,
+    // so reset() and snapshots leave them alone.
+    void setSpawnIntervals(int enemyTicks, int obstacleTicks, int perSpawn = 1);
+    
+    // Enemies alive at once, all types together (default MAX_ENEMIES).
+    // Reserves storage, so unlike stepping this allocates; it never goes
+    // below the enemies alive now. getMaxSnapshotSize grows with it, and a
+    // snapshot only restores into a world with room for its enemies.
+    void setEnemyCapacity(size_t capacity);
+    size_t getEnemyCapacity() const { return enemyCapacity; }
+    void addExplosion(float x, float y, int count) { createExplosion(x, y, count); }
+    
+    void render(RenderBackend* renderer);
+    
+    // Effects level for render(); defaults to the high tier
+    void setRenderQuality(const RenderQuality& newQuality) { quality = newQuality; }
+    
+    // Free textures created for a renderer, before destroying it
+    void releaseRenderResources();
+    
+    // Snapshots: the complete simulation state (entities, terrain, stats,
+    // timers, RNG) as a flat byte buffer. Neither call allocates.
+    // saveSnapshot returns the bytes written, or 0 if the buffer is too
+    // small; restoreSnapshot rejects buffers from a different world size.
+    size_t getMaxSnapshotSize() const;
+    size_t saveSnapshot(void* buffer, size_t capacity) const;
+    bool restoreSnapshot(const void* buffer, size_t size);
+    
+    // Getters
+    const Helicopter& getPlayer() const { return *player; }
+    const Terrain& getTerrain() const { return *terrain; }
+    const std::vector<Enemy>& getEnemies(EnemyType type) const { return enemies[static_cast<int>(type)]; }
+    const std::vector<Obstacle>& getObstacles(ObstacleType type) const { return obstacles[static_cast<int>(type)]; }
+    size_t getBulletCount() const { return bullets.size(); }
+    size_t getEnemyCount() const;
+    size_t getObstacleCount() const;
+    size_t getParticleCount() const { return particles.size(); }
+    int getScore() const { return score; }
+    float getDistance() const { return distanceTraveled; }
+    int getEnemiesKilled() const { return enemiesKilled; }
+    bool isGameOver() const { return gameOver; }
+    DeathCause getDeathCause() const { return deathCause; }
+    const StepEvents& getEvents() const { return events; }
+    unsigned int getTick() const { return tick; }
+    unsigned int getSeed() const { return seed; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+};
+
+#endif
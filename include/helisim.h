@@ -0,0 +1,141 @@
+#ifndef HELISIM_H
+#define HELISIM_H
+
+/*
+ * helisim - C interface to the helicopter game simulation.
+ *
+ * Built as libhelisim.so so training harnesses and other languages can step
+ * the game without a window. All calls are synchronous; a world must only be
+ * used from one thread at a time. No call allocates after helisim_create
+ * (or helisim_render_init when pixel observations are used, and
+ * helisim_set_spawning when it raises the enemy capacity).
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(HELISIM_BUILD) && defined(__GNUC__)
+#define HELISIM_API __attribute__((visibility("default")))
+#else
+#define HELISIM_API
+#endif
+
+#define HELISIM_MAX_ENEMIES 32
+#define HELISIM_MAX_OBSTACLES 32
+
+/* Action bits for helisim_step */
+#define HELISIM_ACTION_THRUST 0x1u
+#define HELISIM_ACTION_SHOOT  0x2u
+
+typedef struct helisim_world helisim_world;
+
+typedef struct {
+    float x, y;
+    float velocity_y;
+    float rotation;
+    int32_t health;
+    int32_t alive;
+} helisim_player;
+
+typedef struct {
+    float x, y;
+    int32_t width, height;
+    int32_t type;   /* EnemyType / ObstacleType ordinal */
+    uint32_t id;    /* Spawn sequence number, unique within a run; follows
+                       the entity from tick to tick */
+} helisim_entity;
+
+typedef struct {
+    helisim_player player;
+
+    /* Gap in pixels between the player and the nearest ground/ceiling point
+       under/over it; negative when overlapping */
+    int32_t ground_clearance;
+    int32_t ceiling_clearance;
+
+    int32_t score;
+    int32_t enemies_killed;
+    float distance;
+    uint32_t tick;
+    int32_t done;
+
+    /* Live entities in spawn order (oldest first, rising id). num_* is
+       clamped to the array size, keeping the oldest; total_* is the real
+       count. */
+    int32_t num_enemies;
+    int32_t total_enemies;
+    helisim_entity enemies[HELISIM_MAX_ENEMIES];
+    int32_t num_obstacles;
+    int32_t total_obstacles;
+    helisim_entity obstacles[HELISIM_MAX_OBSTACLES];
+} helisim_observation;
+
+/* Rendered frame. pixels points into memory owned by the world and stays
+   valid until the next helisim_render, helisim_render_init or
+   helisim_destroy. 4-channel frames are XRGB8888 (bytes B, G, R, X on
+   little-endian hosts); 1-channel frames are 8-bit luma. */
+typedef struct {
+    const uint8_t* pixels;
+    int32_t width, height;
+    int32_t pitch;      /* bytes per row */
+    int32_t channels;   /* 1 or 4 */
+} helisim_frame;
+
+/* Create a world reset with seed 1. Returns NULL on allocation failure. */
+HELISIM_API helisim_world* helisim_create(void);
+HELISIM_API void helisim_destroy(helisim_world* world);
+
+/* Start a new run; the same seed always reproduces the same run. */
+HELISIM_API void helisim_reset(helisim_world* world, uint32_t seed);
+
+/* Advance up to `ticks` ticks holding `action` (HELISIM_ACTION_* bits).
+   Stops early when the run ends. Returns the number of ticks simulated. */
+HELISIM_API int32_t helisim_step(helisim_world* world, int32_t ticks, uint32_t action);
+
+/* Write the current state into a caller-owned observation. */
+HELISIM_API void helisim_observe(const helisim_world* world, helisim_observation* out);
+
+/* Spawn settings for stress tests and curricula: ticks between enemy and
+   obstacle spawns (0 for none; defaults 120 and 90), enemies per enemy
+   spawn (default 1) and how many enemies may be alive at once, all types
+   together (default 64, at most 65535, never below the live count). The
+   settings survive helisim_reset. Raising the capacity allocates and
+   grows helisim_snapshot_max_size; a snapshot only restores into a world
+   with room for its enemies. Returns 0 on success, -1 on invalid
+   arguments or allocation failure. */
+HELISIM_API int32_t helisim_set_spawning(helisim_world* world, int32_t enemy_interval,
+                                         int32_t obstacle_interval, int32_t enemies_per_spawn,
+                                         int32_t enemy_capacity);
+
+/* Upper bound on the size of any snapshot of this world. */
+HELISIM_API uint32_t helisim_snapshot_max_size(const helisim_world* world);
+
+/* Copy the complete simulation state (entities, terrain, score, timers,
+   RNG) into `buffer`. Returns the bytes written, or 0 if `size` is too
+   small. Cheap enough to call every tick; no alignment required. */
+HELISIM_API uint32_t helisim_snapshot(const helisim_world* world, void* buffer, uint32_t size);
+
+/* Put the world back into a state saved by helisim_snapshot, possibly from
+   another world. Stepping afterwards with the same actions reproduces the
+   same future. Returns 0 on success, -1 if the buffer is not a valid
+   snapshot. */
+HELISIM_API int32_t helisim_restore(helisim_world* world, const void* buffer, uint32_t size);
+
+/* Set up pixel observations: an offscreen software renderer at
+   1280x720 / downscale (1..16), optionally converted to grayscale.
+   Needs no display. Returns 0 on success, -1 on failure. */
+HELISIM_API int32_t helisim_render_init(helisim_world* world, int32_t downscale, int32_t grayscale);
+
+/* Draw the playfield (sky, terrain, entities, player) and point `out` at
+   the resulting pixels without copying. Returns 0 on success, -1 if
+   helisim_render_init has not succeeded. */
+HELISIM_API int32_t helisim_render(helisim_world* world, helisim_frame* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,196 @@
+#include "AllocTracker.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+constexpr int TAG_COUNT = static_cast<int>(AllocTag::COUNT);
+
+#ifdef ALLOC_TRACKING
+
+// Each block is prefixed with its size and tag so frees can be charged back.
+// 16 bytes keeps the block aligned for any fundamental type.
+struct BlockHeader {
+    size_t size;
+    AllocTag tag;
+};
+
+constexpr size_t HEADER_SIZE = 16;
+static_assert(sizeof(BlockHeader) <= HEADER_SIZE, "block header must fit its slot");
+static_assert(HEADER_SIZE % alignof(std::max_align_t) == 0, "block header must keep alignment");
+
+struct TagStats {
+    std::atomic<Uint64> allocs;
+    std::atomic<Uint64> bytes;
+    std::atomic<Sint64> live;
+    std::atomic<Sint64> peak;
+};
+
+// Zero-initialized before any constructor runs, so allocations made during
+// static initialization are counted too
+TagStats tagStats[TAG_COUNT];
+std::atomic<Uint64> frameAllocs;
+std::atomic<Uint64> frameBytes;
+
+#endif
+
+// Frame history, only touched by the thread calling endFrame()
+Uint64 frames;
+Uint64 framesAllocating;
+Uint64 totalFrameAllocs;
+Uint64 totalFrameBytes;
+Uint64 worstFrameAllocs;
+Uint64 worstFrameBytes;
+
+#ifdef ALLOC_TRACKING
+
+[[noreturn]] void guardTripped(AllocTag tag, size_t size) {
+    // Reporting must not trip the guard again; stderr is unbuffered, so
+    // fputs doesn't allocate
+    allocContext.guarded = false;
+    char message[128];
+    std::snprintf(message, sizeof(message), "Allocation of %zu bytes (%s) inside a no-allocation region\n",
+                  size, AllocTracker::getTagName(tag));
+    std::fputs(message, stderr);
+    std::abort();
+}
+
+void* allocate(size_t size) {
+    AllocContext& context = allocContext;
+    if (context.guarded) guardTripped(context.tag, size);
+    
+    void* block = std::malloc(size + HEADER_SIZE);
+    if (!block) return nullptr;
+    
+    BlockHeader* header = static_cast<BlockHeader*>(block);
+    header->size = size;
+    header->tag = context.tag;
+    
+    TagStats& stats = tagStats[static_cast<int>(context.tag)];
+    stats.allocs.fetch_add(1, std::memory_order_relaxed);
+    stats.bytes.fetch_add(size, std::memory_order_relaxed);
+    Sint64 live = stats.live.fetch_add(static_cast<Sint64>(size), std::memory_order_relaxed) + size;
+    Sint64 peak = stats.peak.load(std::memory_order_relaxed);
+    while (live > peak && !stats.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+    
+    frameAllocs.fetch_add(1, std::memory_order_relaxed);
+    frameBytes.fetch_add(size, std::memory_order_relaxed);
+    return static_cast<Uint8*>(block) + HEADER_SIZE;
+}
+
+void release(void* pointer) {
+    if (!pointer) return;
+    
+    void* block = static_cast<Uint8*>(pointer) - HEADER_SIZE;
+    const BlockHeader* header = static_cast<const BlockHeader*>(block);
+    tagStats[static_cast<int>(header->tag)].live.fetch_sub(static_cast<Sint64>(header->size),
+                                                            std::memory_order_relaxed);
+    std::free(block);
+}
+
+void* allocateOrThrow(size_t size) {
+    // operator new(0) must still return a unique pointer
+    void* pointer = allocate(size ? size : 1);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+#endif
+
+}
+
+#ifdef ALLOC_TRACKING
+
+// Over-aligned allocations keep the library's aligned operators and go
+// uncounted; nothing in the game asks for more than max_align_t
+void* operator new(size_t size) { return allocateOrThrow(size); }
+void* operator new[](size_t size) { return allocateOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate(size ? size : 1); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate(size ? size : 1); }
+void operator delete(void* pointer) noexcept { release(pointer); }
+void operator delete[](void* pointer) noexcept { release(pointer); }
+void operator delete(void* pointer, size_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { release(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+
+bool AllocTracker::isBuiltIn() {
+    return true;
+}
+
+void AllocTracker::endFrame() {
+    Uint64 allocs = frameAllocs.exchange(0, std::memory_order_relaxed);
+    Uint64 bytes = frameBytes.exchange(0, std::memory_order_relaxed);
+    
+    frames++;
+    if (allocs > 0) framesAllocating++;
+    totalFrameAllocs += allocs;
+    totalFrameBytes += bytes;
+    if (allocs > worstFrameAllocs) worstFrameAllocs = allocs;
+    if (bytes > worstFrameBytes) worstFrameBytes = bytes;
+}
+
+#else
+
+bool AllocTracker::isBuiltIn() {
+    return false;
+}
+
+void AllocTracker::endFrame() {
+}
+
+#endif
+
+const char* AllocTracker::getTagName(AllocTag tag) {
+    switch (tag) {
+        case AllocTag::OTHER: return "other";
+        case AllocTag::WORLD: return "world";
+        case AllocTag::BULLETS: return "bullets";
+        case AllocTag::ENEMIES: return "enemies";
+        case AllocTag::OBSTACLES: return "obstacles";
+        case AllocTag::PARTICLES: return "particles";
+        case AllocTag::TERRAIN: return "terrain";
+        case AllocTag::SPRITES: return "sprites";
+        case AllocTag::REWIND: return "rewind";
+        case AllocTag::RENDER: return "render";
+        case AllocTag::IO: return "io";
+        case AllocTag::AUDIO: return "audio";
+        default: return "?";
+    }
+}
+
+void AllocTracker::printReport(FILE* out) {
+    if (!isBuiltIn()) {
+        std::fprintf(out, "Allocations: not tracked in this build (make ALLOC_TRACKING=1)\n");
+        return;
+    }
+    
+    if (frames == 0) {
+        std::fprintf(out, "Allocations: no frames\n");
+    } else {
+        double n = static_cast<double>(frames);
+        std::fprintf(out, "Allocations: %llu frames, %.2f allocs and %.0f bytes per frame average\n",
+                     static_cast<unsigned long long>(frames), totalFrameAllocs / n, totalFrameBytes / n);
+        std::fprintf(out, "  frames allocating: %llu (%.2f%%), worst %llu allocs, %llu bytes\n",
+                     static_cast<unsigned long long>(framesAllocating), 100.0 * framesAllocating / n,
+                     static_cast<unsigned long long>(worstFrameAllocs),
+                     static_cast<unsigned long long>(worstFrameBytes));
+    }
+
+#ifdef ALLOC_TRACKING
+    std::fprintf(out, "  %-10s %10s %12s %12s %12s\n", "tag", "allocs", "bytes", "live", "peak live");
+    for (int i = 0; i < TAG_COUNT; i++) {
+        const TagStats& stats = tagStats[i];
+        Uint64 allocs = stats.allocs.load(std::memory_order_relaxed);
+        if (allocs == 0) continue;
+        std::fprintf(out, "  %-10s %10llu %12llu %12lld %12lld\n", getTagName(static_cast<AllocTag>(i)),
+                     static_cast<unsigned long long>(allocs),
+                     static_cast<unsigned long long>(stats.bytes.load(std::memory_order_relaxed)),
+                     static_cast<long long>(stats.live.load(std::memory_order_relaxed)),
+                     static_cast<long long>(stats.peak.load(std::memory_order_relaxed)));
+    }
+#endif
+}
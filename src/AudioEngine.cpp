@@ -0,0 +1,399 @@
+#include "AudioEngine.h"
+#include "AllocTracker.h"
+#include "Random.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int SOUND_COUNT = static_cast<int>(Sound::COUNT);
+constexpr float TWO_PI = 6.2831853f;
+
+// Stealing rank and how many voices of the sound may play at once
+struct SoundSpec {
+    int priority;
+    int limit;
+};
+
+const SoundSpec SPECS[SOUND_COUNT] = {
+    {0, 1},     // ROTOR, on its own channel
+    {1, 3},     // GUNFIRE
+    {2, 3},     // HIT
+    {3, 4},     // EXPLOSION
+    {4, 1}      // CRASH
+};
+
+// Rotor channel volume idle and under thrust
+constexpr Uint8 ROTOR_IDLE = 40;
+constexpr Uint8 ROTOR_THRUST = 72;
+
+// White noise in [-1, 1], the same every run
+float noise(Random& rng) {
+    return static_cast<float>(rng.next() % 20001) / 10000.0f - 1.0f;
+}
+
+// One mono waveform per sound, at the given rate
+std::vector<float> synthesizeSound(Sound sound, int rate) {
+    Random rng(static_cast<Uint32>(sound) + 1);
+    float seconds = 0.0f;
+    switch (sound) {
+        case Sound::ROTOR:     seconds = 0.5f; break;   // 6 blade slaps, loops seamlessly
+        case Sound::GUNFIRE:   seconds = 0.09f; break;
+        case Sound::HIT:       seconds = 0.14f; break;
+        case Sound::EXPLOSION: seconds = 0.9f; break;
+        case Sound::CRASH:     seconds = 1.6f; break;
+        case Sound::COUNT:     break;
+    }
+    
+    std::vector<float> wave(static_cast<size_t>(seconds * rate));
+    float lowpass = 0.0f;
+    for (size_t i = 0; i < wave.size(); i++) {
+        float t = static_cast<float>(i) / rate;
+        float n = noise(rng);
+        float value = 0.0f;
+        
+        switch (sound) {
+            case Sound::ROTOR: {
+                // Blade slaps at 12 Hz over a 60 Hz drone
+                float sinceSlap = std::fmod(t * 12.0f, 1.0f) / 12.0f;
+                lowpass += 0.15f * (n - lowpass);
+                value = lowpass * std::exp(-sinceSlap / 0.018f) * 2.5f +
+                        0.25f * std::sin(TWO_PI * 60.0f * t) + 0.1f * std::sin(TWO_PI * 120.0f * t);
+                break;
+            }
+            case Sound::GUNFIRE: {
+                // High-passed noise crack with a click on the front
+                lowpass += 0.2f * (n - lowpass);
+                value = (n - lowpass) * std::exp(-t / 0.015f);
+                if (t < 0.004f) value += 0.8f * std::sin(TWO_PI * 1000.0f * t);
+                break;
+            }
+            case Sound::HIT: {
+                // Metallic ping
+                value = (std::sin(TWO_PI * 1250.0f * t) + 0.6f * std::sin(TWO_PI * 1870.0f * t) +
+                         0.3f * std::sin(TWO_PI * 2960.0f * t)) * std::exp(-t / 0.03f) +
+                        0.5f * n * std::exp(-t / 0.004f);
+                break;
+            }
+            case Sound::EXPLOSION:
+            case Sound::CRASH: {
+                // Noise whose brightness falls away, over a sinking thump
+                bool crash = sound == Sound::CRASH;
+                float decay = crash ? 0.45f : 0.22f;
+                float thump = crash ? 36.0f : 48.0f;
+                lowpass += (0.02f + 0.3f * std::exp(-t / 0.1f)) * (n - lowpass);
+                value = std::min(1.0f, t / 0.004f) * lowpass * std::exp(-t / decay) * 3.0f +
+                        0.6f * std::sin(TWO_PI * thump * t * (1.0f - 0.3f * t)) * std::exp(-t / (decay * 1.4f));
+                if (crash && rng.next() % 2000 == 0) value += 0.5f * n;
+                break;
+            }
+            case Sound::COUNT:
+                break;
+        }
+        wave[i] = value;
+    }
+    
+    // One-shots fade out over the last 5 ms so they don't end in a click
+    if (sound != Sound::ROTOR) {
+        size_t fade = std::min(wave.size(), static_cast<size_t>(rate / 200));
+        for (size_t i = 0; i < fade; i++) {
+            wave[wave.size() - 1 - i] *= static_cast<float>(i) / fade;
+        }
+    }
+    
+    // Peak at 80% of full scale
+    float peak = 0.0f;
+    for (float value : wave) {
+        peak = std::max(peak, std::fabs(value));
+    }
+    if (peak > 0.0f) {
+        for (float& value : wave) {
+            value *= 0.8f / peak;
+        }
+    }
+    return wave;
+}
+
+}
+
+AudioEngine::AudioEngine()
+    : opened(false), frequency(0), channels(0),
+      counterFrequency(static_cast<double>(SDL_GetPerformanceFrequency())),
+      chunks(), queue(), queueHead(0), queueTail(0), wake(nullptr),
+      rotorRunning(false), rotorThrust(false), triggers(0), queueFull(0),
+      voices(), played(0), merged(0), stolen(0), refused(0), peakVoices(0),
+      latencySum(0), worstLatency(0) {
+}
+
+AudioEngine::~AudioEngine() {
+    shutdown();
+}
+
+bool AudioEngine::init() {
+    if (opened) return true;
+    
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) return false;
+    if (Mix_OpenAudio(FREQUENCY, MIX_DEFAULT_FORMAT, 2, BUFFER_FRAMES) < 0) {
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+    
+    // Samples are written in the device's own format; SDL_mixer keeps the
+    // requested sample format but may change the rate or channel count
+    Uint16 format = 0;
+    if (!Mix_QuerySpec(&frequency, &format, &channels) || format != AUDIO_S16SYS || channels < 1) {
+        Mix_CloseAudio();
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+    Mix_AllocateChannels(VOICES);
+    
+    {
+        AllocScope scope(AllocTag::AUDIO);
+        synthesize();
+    }
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        std::vector<Sint16>& data = samples[i];
+        chunks[i] = Mix_QuickLoad_RAW(reinterpret_cast<Uint8*>(data.data()),
+                                      static_cast<Uint32>(data.size() * sizeof(Sint16)));
+    }
+    wake = SDL_CreateSemaphore(0);
+    
+    opened = true;
+    if (!wake || std::find(chunks, chunks + SOUND_COUNT, nullptr) != chunks + SOUND_COUNT) {
+        shutdown();
+        return false;
+    }
+    
+    dispatcher = std::thread(&AudioEngine::run, this);
+    return true;
+}
+
+void AudioEngine::shutdown() {
+    if (!opened) return;
+    
+    if (dispatcher.joinable()) {
+        // Everything queued before this still plays out
+        while (queueHead.load(std::memory_order_relaxed) - queueTail.load(std::memory_order_acquire) >= QUEUE_SIZE) {
+            SDL_Delay(1);
+        }
+        push(Command::QUIT, Sound::ROTOR, 0.0f, 0.0f);
+        dispatcher.join();
+    }
+    
+    for (int channel = 0; channel < VOICES; channel++) {
+        Mix_HaltChannel(channel);
+    }
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        if (chunks[i]) {
+            Mix_FreeChunk(chunks[i]);
+            chunks[i] = nullptr;
+        }
+        std::vector<Sint16>().swap(samples[i]);
+    }
+    if (wake) {
+        SDL_DestroySemaphore(wake);
+        wake = nullptr;
+    }
+    Mix_CloseAudio();
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    opened = false;
+}
+
+void AudioEngine::synthesize() {
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        std::vector<float> wave = synthesizeSound(static_cast<Sound>(i), frequency);
+        
+        // Same signal on every output channel, interleaved
+        std::vector<Sint16>& data = samples[i];
+        data.resize(wave.size() * channels);
+        for (size_t frame = 0; frame < wave.size(); frame++) {
+            Sint16 value = static_cast<Sint16>(std::lround(wave[frame] * 32767.0f));
+            std::fill_n(&data[frame * channels], channels, value);
+        }
+    }
+}
+
+void AudioEngine::push(Command command, Sound sound, float volume, float pan) {
+    Uint32 head = queueHead.load(std::memory_order_relaxed);
+    if (head - queueTail.load(std::memory_order_acquire) >= QUEUE_SIZE) {
+        queueFull++;
+        return;
+    }
+    
+    Trigger& trigger = queue[head & (QUEUE_SIZE - 1)];
+    trigger.queuedAt = SDL_GetPerformanceCounter();
+    trigger.command = command;
+    trigger.sound = sound;
+    trigger.volume = static_cast<Uint8>(std::lround(std::min(std::max(volume, 0.0f), 1.0f) * MIX_MAX_VOLUME));
+    trigger.pan = static_cast<Sint8>(std::lround(std::min(std::max(pan, -1.0f), 1.0f) * 127.0f));
+    queueHead.store(head + 1, std::memory_order_release);
+    SDL_SemPost(wake);
+}
+
+void AudioEngine::play(Sound sound, float volume, float pan) {
+    if (!opened || sound == Sound::ROTOR) return;
+    
+    triggers++;
+    push(Command::PLAY, sound, volume, pan);
+}
+
+void AudioEngine::setRotor(bool running, bool thrust) {
+    if (!opened) return;
+    
+    float level = static_cast<float>(thrust ? ROTOR_THRUST : ROTOR_IDLE) / MIX_MAX_VOLUME;
+    if (running != rotorRunning) {
+        push(running ? Command::ROTOR_START : Command::ROTOR_STOP, Sound::ROTOR, level, 0.0f);
+    } else if (running && thrust != rotorThrust) {
+        push(Command::ROTOR_LEVEL, Sound::ROTOR, level, 0.0f);
+    }
+    rotorRunning = running;
+    rotorThrust = thrust;
+}
+
+void AudioEngine::run() {
+    AllocScope scope(AllocTag::AUDIO);
+    
+    struct Pending {
+        int count;
+        float volume;
+        float panSum;
+        Uint64 queuedAt;
+    };
+    
+    bool quitting = false;
+    while (!quitting) {
+        SDL_SemWait(wake);
+        
+        // Drain everything queued so far; a burst of the same sound becomes
+        // one voice, a little louder than its loudest trigger
+        Pending pending[SOUND_COUNT] = {};
+        Uint32 tail = queueTail.load(std::memory_order_relaxed);
+        Uint32 head = queueHead.load(std::memory_order_acquire);
+        for (; tail != head; tail++) {
+            const Trigger& trigger = queue[tail & (QUEUE_SIZE - 1)];
+            switch (trigger.command) {
+                case Command::PLAY: {
+                    Pending& entry = pending[static_cast<int>(trigger.sound)];
+                    if (entry.count == 0) entry.queuedAt = trigger.queuedAt;
+                    entry.count++;
+                    entry.volume = std::max(entry.volume, trigger.volume / static_cast<float>(MIX_MAX_VOLUME));
+                    entry.panSum += trigger.pan / 127.0f;
+                    break;
+                }
+                case Command::ROTOR_START:
+                    // A fading channel still counts as playing but ends in
+                    // silence, so a restart during the fade-out cuts it
+                    if (Mix_FadingChannel(0) == MIX_FADING_OUT) {
+                        Mix_HaltChannel(0);
+                    }
+                    Mix_Volume(0, trigger.volume);
+                    if (!Mix_Playing(0)) {
+                        Mix_PlayChannel(0, chunks[static_cast<int>(Sound::ROTOR)], -1);
+                    }
+                    break;
+                case Command::ROTOR_STOP:
+                    Mix_FadeOutChannel(0, 150);
+                    break;
+                case Command::ROTOR_LEVEL:
+                    Mix_Volume(0, trigger.volume);
+                    break;
+                case Command::QUIT:
+                    quitting = true;
+                    break;
+            }
+        }
+        queueTail.store(tail, std::memory_order_release);
+        
+        for (int i = 0; i < SOUND_COUNT; i++) {
+            const Pending& entry = pending[i];
+            if (entry.count == 0) continue;
+            
+            merged += entry.count - 1;
+            float volume = std::min(1.0f, entry.volume + 0.1f * (entry.count - 1));
+            dispatch(static_cast<Sound>(i), volume, entry.panSum / entry.count, entry.queuedAt);
+        }
+    }
+}
+
+int AudioEngine::pickVoice(Sound sound) {
+    const SoundSpec& spec = SPECS[static_cast<int>(sound)];
+    int free = -1;
+    int oldestSame = -1;
+    int sameCount = 0;
+    int victim = -1;
+    int busy = 0;
+    
+    for (int channel = 1; channel < VOICES; channel++) {
+        if (!Mix_Playing(channel)) {
+            if (free < 0) free = channel;
+            continue;
+        }
+        busy++;
+        
+        const Voice& voice = voices[channel];
+        if (voice.sound == sound) {
+            sameCount++;
+            if (oldestSame < 0 || voice.startedAt < voices[oldestSame].startedAt) oldestSame = channel;
+        }
+        
+        // Lowest priority first, oldest among equals
+        int priority = SPECS[static_cast<int>(voice.sound)].priority;
+        if (priority <= spec.priority) {
+            int victimPriority = victim < 0 ? 0 : SPECS[static_cast<int>(voices[victim].sound)].priority;
+            if (victim < 0 || priority < victimPriority ||
+                (priority == victimPriority && voice.startedAt < voices[victim].startedAt)) {
+                victim = channel;
+            }
+        }
+    }
+    
+    if (sameCount >= spec.limit) {
+        stolen++;
+        return oldestSame;
+    }
+    if (free >= 0) {
+        peakVoices = std::max(peakVoices, busy + 1);
+        return free;
+    }
+    if (victim >= 0) {
+        stolen++;
+        return victim;
+    }
+    refused++;
+    return -1;
+}
+
+void AudioEngine::dispatch(Sound sound, float volume, float pan, Uint64 queuedAt) {
+    int channel = pickVoice(sound);
+    if (channel < 0) return;
+    
+    // Playing on a busy channel cuts off what was there
+    Mix_Volume(channel, static_cast<int>(std::lround(volume * MIX_MAX_VOLUME)));
+    Mix_SetPanning(channel, static_cast<Uint8>(255 * std::min(1.0f, 1.0f - pan)),
+                   static_cast<Uint8>(255 * std::min(1.0f, 1.0f + pan)));
+    Mix_PlayChannel(channel, chunks[static_cast<int>(sound)], 0);
+    
+    Uint64 now = SDL_GetPerformanceCounter();
+    voices[channel].sound = sound;
+    voices[channel].startedAt = now;
+    played++;
+    
+    Uint64 latency = now - queuedAt;
+    latencySum += latency;
+    worstLatency = std::max(worstLatency, latency);
+}
+
+void AudioEngine::printReport(FILE* out) const {
+    std::fprintf(out, "Audio: %d Hz, %d channels, %d-frame buffer (%.1f ms), %d voices\n",
+                 frequency, channels, BUFFER_FRAMES, 1000.0 * BUFFER_FRAMES / std::max(frequency, 1), VOICES);
+    std::fprintf(out, "  triggers %llu (%llu dropped with the queue full, %llu merged into bursts)\n",
+                 static_cast<unsigned long long>(triggers), static_cast<unsigned long long>(queueFull),
+                 static_cast<unsigned long long>(merged));
+    std::fprintf(out, "  played %llu, %llu took over a busy voice, %llu refused; at most %d voices busy\n",
+                 static_cast<unsigned long long>(played), static_cast<unsigned long long>(stolen),
+                 static_cast<unsigned long long>(refused), peakVoices);
+    std::fprintf(out, "  trigger to mixer avg %.3f ms, worst %.3f ms\n",
+                 latencySum * 1000.0 / counterFrequency / std::max<Uint64>(played, 1),
+                 worstLatency * 1000.0 / counterFrequency);
+}
@@ -0,0 +1,286 @@
+#include "Benchmark.h"
+#include "World.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const Scenario SCENARIOS[] = {
+    // name, description, seconds, enemy and obstacle intervals,
+    // explosion interval and size, hover height, shoot interval
+    {"empty-sky", "terrain, clouds and the player only; nothing spawns",
+     30, 0, 0, 0, 0, 0.5f, 0},
+    {"dense-enemies", "an enemy every 8 ticks, no obstacles, firing constantly",
+     30, 8, 0, 0, 0, 0.5f, 4},
+    {"explosion-storm", "a 40-particle explosion every 3 ticks over regular play",
+     30, 120, 90, 3, 40, 0.5f, 8},
+    {"long-run", "10 minutes of regular play and terrain scrolling",
+     600, 120, 90, 0, 0, 0.5f, 8}
+};
+
+const size_t SCENARIO_COUNT = sizeof(SCENARIOS) / sizeof(SCENARIOS[0]);
+
+const char* const PHASE_NAMES[BENCH_PHASE_COUNT] = {"update", "render", "raster", "present", "frame"};
+
+const char* const FILE_MAGIC = "helicopter-bench";
+const int FILE_VERSION = 1;
+
+// Changes smaller than this are noise whatever their p-value
+const double MIN_CHANGE_NS = 10000.0;
+
+double toMs(double nanoseconds) {
+    return nanoseconds / 1000000.0;
+}
+
+// The rest of the line after a keyword, without the separating space
+void readRestOfLine(FILE* in, std::string& out) {
+    out.clear();
+    int c = std::fgetc(in);
+    if (c == ' ') c = std::fgetc(in);
+    while (c != EOF && c != '\n') {
+        out += static_cast<char>(c);
+        c = std::fgetc(in);
+    }
+}
+
+}
+
+// --- Scenarios ---
+
+const Scenario* Scenario::getAll(size_t& count) {
+    count = SCENARIO_COUNT;
+    return SCENARIOS;
+}
+
+const Scenario* Scenario::find(const char* name) {
+    for (const Scenario& scenario : SCENARIOS) {
+        if (std::strcmp(scenario.name, name) == 0) return &scenario;
+    }
+    return nullptr;
+}
+
+void Scenario::start(World& world, unsigned int seed) const {
+    world.setSpawnIntervals(enemyInterval, obstacleInterval);
+    world.reset(seed);
+}
+
+void Scenario::drive(World& world, bool& thrust, bool& shoot) const {
+    unsigned int tick = world.getTick();
+    thrust = world.getPlayer().getY() > world.getHeight() * hoverHeight;
+    shoot = shootInterval > 0 && tick % shootInterval == 0;
+    
+    // Spread over the sky in a fixed pattern, independent of the world's RNG
+    if (explosionInterval > 0 && tick % explosionInterval == 0) {
+        unsigned int n = tick / explosionInterval;
+        float x = static_cast<float>(n * 389 % 1000) / 1000.0f * world.getWidth();
+        float y = (0.15f + static_cast<float>(n * 211 % 1000) / 1000.0f * 0.6f) * world.getHeight();
+        world.addExplosion(x, y, explosionSize);
+    }
+}
+
+const char* getBenchPhaseName(BenchPhase phase) {
+    return PHASE_NAMES[static_cast<int>(phase)];
+}
+
+// --- Results files ---
+
+const BenchmarkRun* BenchmarkResults::find(const std::string& scenario) const {
+    for (const BenchmarkRun& run : runs) {
+        if (run.scenario == scenario) return &run;
+    }
+    return nullptr;
+}
+
+bool BenchmarkResults::save(const char* path) const {
+    FILE* out = std::fopen(path, "w");
+    if (!out) return false;
+    
+    std::fprintf(out, "%s %d\nlabel %s\nsettings %s\n", FILE_MAGIC, FILE_VERSION, label.c_str(), settings.c_str());
+    for (const BenchmarkRun& run : runs) {
+        std::fprintf(out, "run %s %zu %u\n", run.scenario.c_str(), run.samples[0].size(), run.resets);
+        for (int phase = 0; phase < BENCH_PHASE_COUNT; phase++) {
+            std::fputs(PHASE_NAMES[phase], out);
+            for (Uint32 sample : run.samples[phase]) {
+                std::fprintf(out, " %u", sample);
+            }
+            std::fputc('\n', out);
+        }
+    }
+    
+    bool ok = !std::ferror(out);
+    return std::fclose(out) == 0 && ok;
+}
+
+bool BenchmarkResults::load(const char* path) {
+    label.clear();
+    settings.clear();
+    runs.clear();
+    
+    FILE* in = std::fopen(path, "r");
+    if (!in) return false;
+    
+    char word[256];
+    int version = 0;
+    bool ok = std::fscanf(in, "%255s %d", word, &version) == 2 &&
+              std::strcmp(word, FILE_MAGIC) == 0 && version == FILE_VERSION;
+    
+    while (ok && std::fscanf(in, "%255s", word) == 1) {
+        if (std::strcmp(word, "label") == 0) {
+            readRestOfLine(in, label);
+        } else if (std::strcmp(word, "settings") == 0) {
+            readRestOfLine(in, settings);
+        } else if (std::strcmp(word, "run") == 0) {
+            // A scenario: its header line, then one line per phase in order
+            unsigned int frames = 0;
+            BenchmarkRun run;
+            ok = std::fscanf(in, "%255s %u %u", word, &frames, &run.resets) == 3;
+            run.scenario = word;
+            for (int phase = 0; ok && phase < BENCH_PHASE_COUNT; phase++) {
+                ok = std::fscanf(in, "%255s", word) == 1 && std::strcmp(word, PHASE_NAMES[phase]) == 0;
+                std::vector<Uint32>& samples = run.samples[phase];
+                samples.resize(frames);
+                for (unsigned int i = 0; ok && i < frames; i++) {
+                    ok = std::fscanf(in, "%u", &samples[i]) == 1;
+                }
+            }
+            if (ok) runs.push_back(std::move(run));
+        } else {
+            ok = false;
+        }
+    }
+    
+    std::fclose(in);
+    return ok;
+}
+
+void BenchmarkResults::printSummary(FILE* out) const {
+    std::vector<Uint32> scratch;
+    for (const BenchmarkRun& run : runs) {
+        std::fprintf(out, "%s: %zu frames, %u resets\n", run.scenario.c_str(), run.samples[0].size(), run.resets);
+        std::fprintf(out, "  phase        mean      p50      p95      p99      max  (ms)\n");
+        for (int phase = 0; phase < BENCH_PHASE_COUNT; phase++) {
+            PhaseSummary summary = summarize(run.samples[phase], scratch);
+            std::fprintf(out, "  %-8s %8.3f %8.3f %8.3f %8.3f %8.3f\n", PHASE_NAMES[phase],
+                         toMs(summary.mean), toMs(summary.p50), toMs(summary.p95),
+                         toMs(summary.p99), toMs(summary.max));
+        }
+    }
+}
+
+// --- Statistics ---
+
+PhaseSummary summarize(const std::vector<Uint32>& samples, std::vector<Uint32>& scratch) {
+    PhaseSummary summary = {};
+    if (samples.empty()) return summary;
+    
+    scratch.assign(samples.begin(), samples.end());
+    std::sort(scratch.begin(), scratch.end());
+    
+    double sum = 0.0;
+    for (Uint32 sample : scratch) {
+        sum += sample;
+    }
+    size_t count = scratch.size();
+    auto rank = [count](double p) {
+        size_t r = static_cast<size_t>(std::ceil(p / 100.0 * count));
+        return r > 0 ? r - 1 : 0;
+    };
+    
+    summary.mean = sum / count;
+    summary.p50 = scratch[rank(50)];
+    summary.p95 = scratch[rank(95)];
+    summary.p99 = scratch[rank(99)];
+    summary.max = scratch.back();
+    return summary;
+}
+
+double mannWhitneyP(const std::vector<Uint32>& a, const std::vector<Uint32>& b) {
+    double n1 = static_cast<double>(a.size());
+    double n2 = static_cast<double>(b.size());
+    if (a.empty() || b.empty()) return 1.0;
+    
+    // Pool both samples, tagging each value with its side in the low bit
+    std::vector<Uint64> pooled;
+    pooled.reserve(a.size() + b.size());
+    for (Uint32 value : a) {
+        pooled.push_back(static_cast<Uint64>(value) << 1);
+    }
+    for (Uint32 value : b) {
+        pooled.push_back(static_cast<Uint64>(value) << 1 | 1);
+    }
+    std::sort(pooled.begin(), pooled.end());
+    
+    // Rank sum of a, tied values sharing their average rank
+    double rankSumA = 0.0;
+    double tieTerm = 0.0;
+    size_t i = 0;
+    while (i < pooled.size()) {
+        size_t j = i;
+        size_t fromA = 0;
+        while (j < pooled.size() && pooled[j] >> 1 == pooled[i] >> 1) {
+            if ((pooled[j] & 1) == 0) fromA++;
+            j++;
+        }
+        double ties = static_cast<double>(j - i);
+        rankSumA += fromA * (i + 1 + j) / 2.0;
+        tieTerm += ties * ties * ties - ties;
+        i = j;
+    }
+    
+    double n = n1 + n2;
+    double u = rankSumA - n1 * (n1 + 1) / 2.0;
+    double mean = n1 * n2 / 2.0;
+    double variance = n1 * n2 / 12.0 * ((n + 1) - tieTerm / (n * (n - 1)));
+    if (variance <= 0.0) return 1.0;
+    
+    // Continuity correction, then the two-sided normal tail
+    double z = std::max(0.0, std::fabs(u - mean) - 0.5) / std::sqrt(variance);
+    return std::erfc(z / std::sqrt(2.0));
+}
+
+int compareResults(const BenchmarkResults& baseline, const BenchmarkResults& current,
+                   double threshold, double alpha, FILE* out) {
+    if (baseline.settings != current.settings) {
+        std::fprintf(out, "Warning: measured at different settings (%s vs %s)\n",
+                     baseline.settings.c_str(), current.settings.c_str());
+    }
+    std::fprintf(out, "Baseline: %s\nCurrent:  %s\n", baseline.label.c_str(), current.label.c_str());
+    std::fprintf(out, "Significant: median change over %.1f%% and %.0f us with p < %g\n\n",
+                 threshold * 100.0, MIN_CHANGE_NS / 1000.0, alpha);
+    std::fprintf(out, "%-16s %-8s %9s %9s %8s %9s\n", "scenario", "phase", "base p50", "p50", "change", "p");
+    
+    std::vector<Uint32> scratch;
+    int regressions = 0;
+    int improvements = 0;
+    for (const BenchmarkRun& run : current.runs) {
+        const BenchmarkRun* base = baseline.find(run.scenario);
+        if (!base) {
+            std::fprintf(out, "%-16s not in the baseline\n", run.scenario.c_str());
+            continue;
+        }
+        
+        for (int phase = 0; phase < BENCH_PHASE_COUNT; phase++) {
+            double before = summarize(base->samples[phase], scratch).p50;
+            double after = summarize(run.samples[phase], scratch).p50;
+            double change = before > 0.0 ? after / before - 1.0 : 0.0;
+            double p = mannWhitneyP(base->samples[phase], run.samples[phase]);
+            
+            const char* verdict = "";
+            if (p < alpha && std::fabs(change) > threshold && std::fabs(after - before) >= MIN_CHANGE_NS) {
+                if (change > 0.0) {
+                    verdict = "  REGRESSION";
+                    regressions++;
+                } else {
+                    verdict = "  improvement";
+                    improvements++;
+                }
+            }
+            std::fprintf(out, "%-16s %-8s %9.3f %9.3f %+7.1f%% %9.2g%s\n", run.scenario.c_str(), PHASE_NAMES[phase],
+                         toMs(before), toMs(after), change * 100.0, p, verdict);
+        }
+    }
+    
+    std::fprintf(out, "\n%d significant regressions, %d improvements\n", regressions, improvements);
+    return regressions;
+}
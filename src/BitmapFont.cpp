@@ -0,0 +1,91 @@
+#include "BitmapFont.h"
+#include "FontAtlasData.h"  // Generated by tools/fontbake
+#include <vector>
+
+static_assert(FONT_ATLAS_FACES == 3, "FontAtlas holds the three baked sizes");
+
+BitmapFont::BitmapFont()
+    : glyphs(nullptr), texture(nullptr), height(0) {
+}
+
+int BitmapFont::measure(const char* text) const {
+    if (!glyphs) return 0;
+    
+    int width = 0;
+    for (const char* c = text; *c; c++) {
+        int index = static_cast<unsigned char>(*c) - FIRST_CHAR;
+        if (index < 0 || index >= GLYPH_COUNT) index = '?' - FIRST_CHAR;
+        width += glyphs[index].advance;
+    }
+    return width;
+}
+
+void BitmapFont::draw(RenderBackend* renderer, const char* text, int x, int y, SDL_Color color) const {
+    if (!texture) return;
+    
+    SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(texture, color.a);
+    
+    int penX = x;
+    for (const char* c = text; *c; c++) {
+        int index = static_cast<unsigned char>(*c) - FIRST_CHAR;
+        if (index < 0 || index >= GLYPH_COUNT) index = '?' - FIRST_CHAR;
+        const BakedGlyph& glyph = glyphs[index];
+        
+        if (glyph.w > 0) {
+            SDL_Rect src = {glyph.x, glyph.y, glyph.w, glyph.h};
+            SDL_Rect dest = {penX + glyph.offsetX, y + glyph.offsetY, glyph.w, glyph.h};
+            renderer->copy(texture, &src, &dest);
+        }
+        penX += glyph.advance;
+    }
+}
+
+FontAtlas::FontAtlas() : texture(nullptr) {
+}
+
+FontAtlas::~FontAtlas() {
+    cleanup();
+}
+
+bool FontAtlas::init(SDL_Renderer* renderer) {
+    cleanup();
+    
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                FONT_ATLAS_WIDTH, FONT_ATLAS_HEIGHT);
+    if (!texture) return false;
+    
+    // Coverage becomes alpha on white so color mod can tint it
+    std::vector<Uint32> pixels(static_cast<size_t>(FONT_ATLAS_WIDTH) * FONT_ATLAS_HEIGHT);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = (static_cast<Uint32>(FONT_ATLAS_ALPHA[i]) << 24) | 0x00FFFFFF;
+    }
+    SDL_UpdateTexture(texture, nullptr, pixels.data(), FONT_ATLAS_WIDTH * sizeof(Uint32));
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    
+    for (int i = 0; i < FACE_COUNT; i++) {
+        fonts[i].glyphs = FONT_ATLAS_GLYPHS[i];
+        fonts[i].height = FONT_ATLAS_HEIGHTS[i];
+        fonts[i].texture = texture;
+    }
+    return true;
+}
+
+void FontAtlas::cleanup() {
+    for (BitmapFont& font : fonts) {
+        font.texture = nullptr;
+    }
+    if (texture) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+}
+
+const BitmapFont* FontAtlas::getFont(int pointSize) const {
+    if (!texture) return nullptr;
+    
+    for (int i = 0; i < FACE_COUNT; i++) {
+        if (FONT_ATLAS_SIZES[i] == pointSize) return &fonts[i];
+    }
+    return nullptr;
+}
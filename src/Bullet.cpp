@@ -13,13 +13,13 @@ void Bullet::update() {
     }
 }
 
-void Bullet::render(SDL_Renderer* renderer) {
+void Bullet::render(RenderBackend* renderer) {
     if (!active) return;
     
     // Yellow bullet
-    SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
+    renderer->setDrawColor(255, 255, 0, 255);
     SDL_Rect rect = {static_cast<int>(x), static_cast<int>(y), width, height};
-    SDL_RenderFillRect(renderer, &rect);
+    renderer->fillRect(&rect);
 }
 
 SDL_Rect Bullet::getBounds() const {
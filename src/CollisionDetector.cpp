@@ -23,6 +23,15 @@ bool CollisionDetector::checkCollision(const SDL_Rect& a, const SDL_Rect& b) {
     return true;
 }
 
+bool CollisionDetector::checkCollision(const SDL_Rect& a, const CollisionMask& maskA,
+                                       const SDL_Rect& b, const CollisionMask& maskB) {
+    return checkCollision(a, b) && maskA.overlaps(a, maskB, b);
+}
+
+bool CollisionDetector::checkCollision(const SDL_Rect& a, const CollisionMask& maskA, const SDL_Rect& b) {
+    return checkCollision(a, b) && maskA.overlapsRect(a, b);
+}
+
 bool CollisionDetector::pointInRect(int x, int y, const SDL_Rect& rect) {
     return (x >= rect.x && x <= rect.x + rect.w &&
             y >= rect.y && y <= rect.y + rect.h);
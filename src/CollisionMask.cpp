@@ -0,0 +1,142 @@
+#include "CollisionMask.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+CollisionMask::CollisionMask(int width, int height)
+    : rows(), width(std::max(0, std::min(width, MAX_SIZE))), height(std::max(0, std::min(height, MAX_SIZE))) {
+}
+
+void CollisionMask::set(int x, int y) {
+    if (x < 0 || x >= width || y < 0 || y >= height) return;
+    rows[y] |= 1ULL << x;
+}
+
+bool CollisionMask::test(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height) return false;
+    return (rows[y] >> x) & 1;
+}
+
+bool CollisionMask::overlaps(const SDL_Rect& bounds, const CollisionMask& other, const SDL_Rect& otherBounds) const {
+    // Columns of `other` relative to ours; masks this far apart can't touch
+    int dx = otherBounds.x - bounds.x;
+    if (dx >= width || -dx >= other.width) return false;
+    
+    int top = std::max(bounds.y, otherBounds.y);
+    int bottom = std::min(bounds.y + height, otherBounds.y + other.height);
+    const Uint64* ours = rows + (top - bounds.y);
+    const Uint64* theirs = other.rows + (top - otherBounds.y);
+    
+    for (int i = 0; i < bottom - top; i++) {
+        Uint64 shifted = dx >= 0 ? theirs[i] << dx : theirs[i] >> -dx;
+        if (ours[i] & shifted) return true;
+    }
+    return false;
+}
+
+bool CollisionMask::overlapsRect(const SDL_Rect& bounds, const SDL_Rect& rect) const {
+    int left = std::max(rect.x - bounds.x, 0);
+    int right = std::min(rect.x + rect.w - bounds.x, width);
+    int top = std::max(rect.y - bounds.y, 0);
+    int bottom = std::min(rect.y + rect.h - bounds.y, height);
+    if (left >= right || top >= bottom) return false;
+    
+    int span = right - left;
+    Uint64 columns = (span == 64 ? ~0ULL : (1ULL << span) - 1) << left;
+    for (int y = top; y < bottom; y++) {
+        if (rows[y] & columns) return true;
+    }
+    return false;
+}
+
+CollisionMask CollisionMask::rotated(double degrees, float pivotX, float pivotY,
+                                     int left, int top, int width, int height) const {
+    CollisionMask out(width, height);
+    double radians = degrees * 3.14159265358979323846 / 180.0;
+    double c = std::cos(radians);
+    double s = std::sin(radians);
+    
+    // Map each output pixel back through the inverse rotation
+    for (int y = 0; y < out.height; y++) {
+        for (int x = 0; x < out.width; x++) {
+            double dx = left + x + 0.5 - pivotX;
+            double dy = top + y + 0.5 - pivotY;
+            double sourceX = pivotX + dx * c + dy * s;
+            double sourceY = pivotY - dx * s + dy * c;
+            if (test(static_cast<int>(std::floor(sourceX)), static_cast<int>(std::floor(sourceY)))) {
+                out.set(x, y);
+            }
+        }
+    }
+    return out;
+}
+
+void MaskRenderBackend::setDrawColor(Uint8, Uint8, Uint8, Uint8 a) {
+    solid = a >= 128;
+}
+
+void MaskRenderBackend::fillClipped(int x1, int y1, int x2, int y2) {
+    // Half-open [x1, x2) x [y1, y2)
+    x1 = std::max(x1, 0);
+    y1 = std::max(y1, 0);
+    x2 = std::min(x2, mask.getWidth());
+    y2 = std::min(y2, mask.getHeight());
+    for (int y = y1; y < y2; y++) {
+        for (int x = x1; x < x2; x++) {
+            mask.set(x, y);
+        }
+    }
+}
+
+void MaskRenderBackend::clear() {
+    if (solid) fillClipped(0, 0, mask.getWidth(), mask.getHeight());
+}
+
+void MaskRenderBackend::fillRect(const SDL_Rect* rect) {
+    if (!solid) return;
+    if (!rect) {
+        fillClipped(0, 0, mask.getWidth(), mask.getHeight());
+        return;
+    }
+    fillClipped(rect->x, rect->y, rect->x + rect->w, rect->y + rect->h);
+}
+
+void MaskRenderBackend::fillRects(const SDL_Rect* rects, int count) {
+    for (int i = 0; i < count; i++) {
+        fillRect(&rects[i]);
+    }
+}
+
+void MaskRenderBackend::drawRect(const SDL_Rect* rect) {
+    if (!solid) return;
+    SDL_Rect r = rect ? *rect : SDL_Rect{0, 0, mask.getWidth(), mask.getHeight()};
+    if (r.w <= 0 || r.h <= 0) return;
+    fillClipped(r.x, r.y, r.x + r.w, r.y + 1);
+    fillClipped(r.x, r.y + r.h - 1, r.x + r.w, r.y + r.h);
+    fillClipped(r.x, r.y, r.x + 1, r.y + r.h);
+    fillClipped(r.x + r.w - 1, r.y, r.x + r.w, r.y + r.h);
+}
+
+void MaskRenderBackend::drawLine(int x1, int y1, int x2, int y2) {
+    if (!solid) return;
+    
+    // Bresenham, both endpoints included like SDL
+    int dx = std::abs(x2 - x1);
+    int dy = -std::abs(y2 - y1);
+    int stepX = x1 < x2 ? 1 : -1;
+    int stepY = y1 < y2 ? 1 : -1;
+    int error = dx + dy;
+    for (;;) {
+        mask.set(x1, y1);
+        if (x1 == x2 && y1 == y2) break;
+        int twice = 2 * error;
+        if (twice >= dy) {
+            error += dy;
+            x1 += stepX;
+        }
+        if (twice <= dx) {
+            error += dx;
+            y1 += stepY;
+        }
+    }
+}
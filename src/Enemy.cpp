@@ -1,128 +1,293 @@
 #include "Enemy.h"
+#include "SpriteCache.h"
+#include <algorithm>
 #include <cmath>
 
-Enemy::Enemy(float startX, float startY, EnemyType enemyType)
+namespace {
+
+constexpr float TWO_PI = 6.2831853f;
+
+// What a script step does over its ticks. Moves are relative to where the
+// step began, so a script flies the same from any spawn height.
+enum class StepOp : Uint8 {
+    WAIT,       // Hover in place
+    MOVE,       // Ease by (a, b) px
+    SINE,       // Fly at a px per tick, bobbing b px over a period of c ticks
+    DIVE,       // Fly at a px per tick, closing on the player's height at up to b px per tick
+    REPEAT,     // Go back to step target, ticks more times; takes no time and doesn't nest
+    EXIT        // Fly off at a px per tick until retired off-screen
+};
+
+struct ScriptStep {
+    StepOp op;
+    Uint8 target;
+    Uint16 ticks;
+    float a, b, c;
+};
+
+const ScriptStep SWOOP_STEPS[] = {
+    {StepOp::MOVE, 0, 50, -300.0f, 0.0f, 0.0f},
+    {StepOp::WAIT, 0, 40, 0.0f, 0.0f, 0.0f},
+    {StepOp::DIVE, 0, 120, -5.0f, 2.0f, 0.0f},
+    {StepOp::EXIT, 0, 0, -4.0f, 0.0f, 0.0f}
+};
+
+const ScriptStep WEAVE_STEPS[] = {
+    {StepOp::SINE, 0, 180, -3.0f, 70.0f, 90.0f},    // Whole periods, so it ends level
+    {StepOp::SINE, 0, 160, -4.0f, 35.0f, 40.0f},
+    {StepOp::EXIT, 0, 0, -4.0f, 0.0f, 0.0f}
+};
+
+const ScriptStep AMBUSH_STEPS[] = {
+    {StepOp::MOVE, 0, 60, -350.0f, 0.0f, 0.0f},
+    {StepOp::WAIT, 0, 25, 0.0f, 0.0f, 0.0f},
+    {StepOp::MOVE, 0, 25, 0.0f, 60.0f, 0.0f},
+    {StepOp::WAIT, 0, 15, 0.0f, 0.0f, 0.0f},
+    {StepOp::MOVE, 0, 25, 0.0f, -60.0f, 0.0f},
+    {StepOp::REPEAT, 1, 2, 0.0f, 0.0f, 0.0f},
+    {StepOp::DIVE, 0, 150, -6.0f, 2.5f, 0.0f},
+    {StepOp::EXIT, 0, 0, -5.0f, 0.0f, 0.0f}
+};
+
+// Indexed by EnemyScript; every script ends in EXIT
+const ScriptStep* const SCRIPTS[ENEMY_SCRIPT_COUNT] = {SWOOP_STEPS, WEAVE_STEPS, AMBUSH_STEPS};
+
+}
+
+Enemy::Enemy(Uint32 id, float startX, float startY, EnemyType enemyType, EnemyScript enemyScript)
     : x(startX), y(startY), startY(startY), velocityX(-2.0f),
-      width(40), height(30), health(30), active(true), type(enemyType), timeAlive(0) {
+      width(WIDTH), height(HEIGHT), health(30), active(true), type(enemyType), id(id), timeAlive(0),
+      startX(startX), script(enemyScript), step(0), repeats(0), stepTicks(0) {
 }
 
-void Enemy::update(float playerX, float playerY) {
-    if (!active) return;
+// Entities are only ever inactive between a collision and the end-of-tick
+// cleanup, so the kernels don't check; they only retire enemies that left
+// the screen.
+template <>
+void Enemy::updateAll<EnemyType::STATIONARY>(Enemy* enemies, size_t count, float) {
+    for (size_t i = 0; i < count; i++) {
+        Enemy& e = enemies[i];
+        e.timeAlive += 0.1f;
+        e.x += e.velocityX;
+        e.active = e.active && e.x >= -e.width;
+    }
+}
+
+template <>
+void Enemy::updateAll<EnemyType::SINE_WAVE>(Enemy* enemies, size_t count, float) {
+    for (size_t i = 0; i < count; i++) {
+        Enemy& e = enemies[i];
+        e.timeAlive += 0.1f;
+        e.x += e.velocityX;
+        e.active = e.active && e.x >= -e.width;
+    }
     
-    timeAlive += 0.1f;
+    // Sines in their own pass, one after another
+    for (size_t i = 0; i < count; i++) {
+        enemies[i].y = enemies[i].startY + std::sin(enemies[i].timeAlive) * 50.0f;
+    }
+}
+
+template <>
+void Enemy::updateAll<EnemyType::CHARGING>(Enemy* enemies, size_t count, float playerY) {
+    // Close in on the player vertically, holding still within 10 px
+    float above = playerY - 10;
+    float below = playerY + 10;
+    for (size_t i = 0; i < count; i++) {
+        Enemy& e = enemies[i];
+        e.timeAlive += 0.1f;
+        e.x += e.velocityX;
+        e.y += 1.5f * (static_cast<int>(e.y < above) - static_cast<int>(e.y > below));
+        e.active = e.active && e.x >= -e.width;
+    }
+}
+
+// The scheduler: every scripted enemy is resumed once per tick, where its
+// script left off. Nothing is allocated; the whole script state is a few
+// bytes in the enemy.
+template <>
+void Enemy::updateAll<EnemyType::SCRIPTED>(Enemy* enemies, size_t count, float playerY) {
+    for (size_t i = 0; i < count; i++) {
+        Enemy& e = enemies[i];
+        e.timeAlive += 0.1f;
+        e.runScript(playerY);
+        e.active = e.active && e.x >= -e.width;
+    }
+}
+
+void Enemy::nextStep(int index) {
+    step = static_cast<Uint8>(index);
+    stepTicks = 0;
+    startX = x;
+    startY = y;
+}
+
+void Enemy::runScript(float playerY) {
+    const ScriptStep* steps = SCRIPTS[static_cast<int>(script)];
     
-    switch(type) {
-        case EnemyType::STATIONARY:
-            x += velocityX;
+    // Loops take no time; the bound only stops a REPEAT that targets itself
+    for (int jumps = 0; steps[step].op == StepOp::REPEAT && jumps < 4; jumps++) {
+        const ScriptStep& loop = steps[step];
+        if (repeats < loop.ticks) {
+            repeats++;
+            nextStep(loop.target);
+        } else {
+            repeats = 0;
+            nextStep(step + 1);
+        }
+    }
+    
+    const ScriptStep& current = steps[step];
+    if (current.op == StepOp::EXIT) {
+        x += current.a;
+        return;
+    }
+    
+    stepTicks++;
+    switch (current.op) {
+        case StepOp::MOVE: {
+            float t = static_cast<float>(stepTicks) / current.ticks;
+            float eased = t * t * (3.0f - 2.0f * t);
+            x = startX + current.a * eased;
+            y = startY + current.b * eased;
+            break;
+        }
+        case StepOp::SINE:
+            x += current.a;
+            y = startY + current.b * std::sin(TWO_PI * stepTicks / current.c);
             break;
-            
-        case EnemyType::SINE_WAVE:
-            x += velocityX;
-            y = startY + std::sin(timeAlive) * 50.0f;
+        case StepOp::DIVE:
+            x += current.a;
+            y += std::min(std::max(playerY - y, -current.b), current.b);
             break;
-            
-        case EnemyType::CHARGING:
-            x += velocityX;
-            // Move towards player vertically
-            if (y < playerY - 10) {
-                y += 1.5f;
-            } else if (y > playerY + 10) {
-                y -= 1.5f;
-            }
+        case StepOp::WAIT:
+        case StepOp::REPEAT:
+        case StepOp::EXIT:
             break;
     }
-    
-    // Deactivate if off-screen
-    if (x < -width) {
-        active = false;
+    if (stepTicks >= current.ticks) {
+        nextStep(step + 1);
     }
 }
 
-void Enemy::render(SDL_Renderer* renderer) {
+bool Enemy::isAttacking() const {
+    return type == EnemyType::CHARGING ||
+           (type == EnemyType::SCRIPTED && SCRIPTS[static_cast<int>(script)][step].op == StepOp::DIVE);
+}
+
+void Enemy::render(RenderBackend* renderer, const SpriteCache& sprites, bool shadows) {
     if (!active) return;
     
     int intX = static_cast<int>(x);
     int intY = static_cast<int>(y);
     
-    // Shadow
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 60);
-    SDL_Rect shadow = {intX + 2, intY + 28, 38, 6};
-    SDL_RenderFillRect(renderer, &shadow);
+    // Rotor blades (spinning)
+    static int rotorFrame = 0;
+    rotorFrame = (rotorFrame + 1) % 4;
+    
+    // Warning lights (blinking while attacking)
+    bool lights = false;
+    if (isAttacking()) {
+        static int blinkFrame = 0;
+        blinkFrame = (blinkFrame + 1) % 30;
+        lights = blinkFrame < 15;
+    }
+    
+    SDL_Texture* sprite = sprites.getEnemy(rotorFrame % 2, lights, shadows);
+    if (!sprite) {
+        drawSprite(renderer, intX, intY, rotorFrame % 2, lights, shadows);
+        return;
+    }
+    
+    SDL_Rect dest = {intX - SPRITE_ORIGIN_X, intY - SPRITE_ORIGIN_Y, SPRITE_WIDTH, SPRITE_HEIGHT};
+    renderer->copy(sprite, nullptr, &dest);
+}
+
+void Enemy::drawSprite(RenderBackend* renderer, int intX, int intY, int rotorFrame, bool lights, bool shadow) {
+    if (shadow) {
+        renderer->setDrawColor(0, 0, 0, 60);
+        SDL_Rect shadowRect = {intX + 2, intY + 28, 38, 6};
+        renderer->fillRect(&shadowRect);
+    }
     
     // Tail rotor
-    SDL_SetRenderDrawColor(renderer, 60, 60, 60, 255);
+    renderer->setDrawColor(60, 60, 60, 255);
     SDL_Rect tailRotor = {intX + 36, intY + 12, 3, 8};
-    SDL_RenderFillRect(renderer, &tailRotor);
+    renderer->fillRect(&tailRotor);
     
     // Tail boom
-    SDL_SetRenderDrawColor(renderer, 150, 40, 40, 255);
+    renderer->setDrawColor(150, 40, 40, 255);
     SDL_Rect tailBoom = {intX + 25, intY + 12, 12, 8};
-    SDL_RenderFillRect(renderer, &tailBoom);
+    renderer->fillRect(&tailBoom);
     
     // Main body (darker base)
-    SDL_SetRenderDrawColor(renderer, 180, 30, 30, 255);
+    renderer->setDrawColor(180, 30, 30, 255);
     SDL_Rect bodyBase = {intX, intY + 12, 30, 12};
-    SDL_RenderFillRect(renderer, &bodyBase);
+    renderer->fillRect(&bodyBase);
     
     // Main body (lighter top for gradient)
-    SDL_SetRenderDrawColor(renderer, 220, 50, 50, 255);
+    renderer->setDrawColor(220, 50, 50, 255);
     SDL_Rect bodyTop = {intX, intY + 10, 30, 6};
-    SDL_RenderFillRect(renderer, &bodyTop);
+    renderer->fillRect(&bodyTop);
     
     // Cockpit window (dark glass)
-    SDL_SetRenderDrawColor(renderer, 50, 0, 0, 200);
+    renderer->setDrawColor(50, 0, 0, 200);
     SDL_Rect cockpitGlass = {intX + 5, intY + 7, 10, 10};
-    SDL_RenderFillRect(renderer, &cockpitGlass);
+    renderer->fillRect(&cockpitGlass);
     
     // Cockpit frame
-    SDL_SetRenderDrawColor(renderer, 200, 60, 60, 255);
+    renderer->setDrawColor(200, 60, 60, 255);
     SDL_Rect cockpit = {intX + 3, intY + 5, 14, 15};
-    SDL_RenderDrawRect(renderer, &cockpit);
+    renderer->drawRect(&cockpit);
     
     // Landing skid
-    SDL_SetRenderDrawColor(renderer, 70, 70, 70, 255);
+    renderer->setDrawColor(70, 70, 70, 255);
     SDL_Rect skid = {intX + 4, intY + 24, 22, 2};
-    SDL_RenderFillRect(renderer, &skid);
+    renderer->fillRect(&skid);
     SDL_Rect skidSupport = {intX + 8, intY + 22, 2, 3};
-    SDL_RenderFillRect(renderer, &skidSupport);
+    renderer->fillRect(&skidSupport);
     
     // Rotor mast
-    SDL_SetRenderDrawColor(renderer, 60, 60, 60, 255);
+    renderer->setDrawColor(60, 60, 60, 255);
     SDL_Rect rotorMast = {intX + 13, intY + 1, 3, 9};
-    SDL_RenderFillRect(renderer, &rotorMast);
-    
-    // Rotor blades (spinning)
-    static int rotorFrame = 0;
-    rotorFrame = (rotorFrame + 1) % 4;
+    renderer->fillRect(&rotorMast);
     
-    SDL_SetRenderDrawColor(renderer, 100, 100, 100, 180);
-    if (rotorFrame % 2 == 0) {
+    // Rotor blades, alternating between frames
+    renderer->setDrawColor(100, 100, 100, 180);
+    if (rotorFrame == 0) {
         SDL_Rect rotor = {intX + 3, intY + 3, 24, 2};
-        SDL_RenderFillRect(renderer, &rotor);
+        renderer->fillRect(&rotor);
     } else {
         SDL_Rect rotor = {intX + 13, intY - 6, 2, 16};
-        SDL_RenderFillRect(renderer, &rotor);
+        renderer->fillRect(&rotor);
     }
     
     // Rotor hub
-    SDL_SetRenderDrawColor(renderer, 80, 80, 80, 255);
+    renderer->setDrawColor(80, 80, 80, 255);
     SDL_Rect rotorHub = {intX + 12, intY + 2, 5, 3};
-    SDL_RenderFillRect(renderer, &rotorHub);
+    renderer->fillRect(&rotorHub);
     
-    // Warning lights (blinking for charging type)
-    if (type == EnemyType::CHARGING) {
-        static int blinkFrame = 0;
-        blinkFrame = (blinkFrame + 1) % 30;
-        if (blinkFrame < 15) {
-            SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-            SDL_Rect light1 = {intX + 2, intY + 15, 2, 2};
-            SDL_Rect light2 = {intX + 26, intY + 15, 2, 2};
-            SDL_RenderFillRect(renderer, &light1);
-            SDL_RenderFillRect(renderer, &light2);
-        }
+    // Warning lights
+    if (lights) {
+        renderer->setDrawColor(255, 0, 0, 255);
+        SDL_Rect light1 = {intX + 2, intY + 15, 2, 2};
+        SDL_Rect light2 = {intX + 26, intY + 15, 2, 2};
+        renderer->fillRect(&light1);
+        renderer->fillRect(&light2);
     }
 }
 
+const CollisionMask& Enemy::getCollisionMask() {
+    static const CollisionMask mask = [] {
+        CollisionMask traced(WIDTH, HEIGHT);
+        MaskRenderBackend backend(traced);
+        drawSprite(&backend, 0, 0, 0, true);
+        drawSprite(&backend, 0, 0, 1, true);
+        return traced;
+    }();
+    return mask;
+}
+
 void Enemy::takeDamage(int damage) {
     health -= damage;
     if (health <= 0) {
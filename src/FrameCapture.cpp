@@ -0,0 +1,276 @@
+#include "FrameCapture.h"
+#include "AllocTracker.h"
+#include <algorithm>
+#include <iostream>
+
+FrameCapture::FrameCapture()
+    : file(nullptr), format(CaptureFormat::Y4M), policy(CapturePolicy::DROP), width(0), height(0), fps(0),
+      frameBytes(0), slotCount(0), queueHead(0), queueCount(0), stopping(false), writeFailed(false),
+      frequency(static_cast<double>(SDL_GetPerformanceFrequency())),
+      captured(0), dropped(0), written(0), deepestQueue(0),
+      readbackTicks(0), worstReadback(0), blockedTicks(0), writeTicks(0) {
+}
+
+FrameCapture::~FrameCapture() {
+    close();
+}
+
+CaptureFormat FrameCapture::formatForPath(const std::string& path) {
+    const std::string extension = ".y4m";
+    if (path.size() >= extension.size() &&
+        path.compare(path.size() - extension.size(), extension.size(), extension) == 0) {
+        return CaptureFormat::Y4M;
+    }
+    return CaptureFormat::RAW_RGB;
+}
+
+bool FrameCapture::open(const std::string& outputPath, int frameWidth, int frameHeight, int frameRate,
+                        CaptureFormat outputFormat, CapturePolicy framePolicy, int bufferCount) {
+    close();
+    if (frameWidth < 2 || frameHeight < 2) return false;
+    
+    AllocScope scope(AllocTag::IO);
+    
+    file = std::fopen(outputPath.c_str(), "wb");
+    if (!file) return false;
+    
+    path = outputPath;
+    format = outputFormat;
+    policy = framePolicy;
+    width = frameWidth;
+    height = frameHeight;
+    fps = frameRate;
+    
+    if (format == CaptureFormat::Y4M &&
+        std::fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps) < 0) {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+    
+    // Everything per frame is sized here, once
+    slotCount = std::max(bufferCount, 2);
+    frameBytes = static_cast<size_t>(width) * height * 4;
+    pool.assign(frameBytes * slotCount, 0);
+    freeSlots.clear();
+    freeSlots.reserve(slotCount);
+    for (int i = slotCount - 1; i >= 0; i--) {
+        freeSlots.push_back(i);
+    }
+    queue.assign(slotCount, 0);
+    queueHead = 0;
+    queueCount = 0;
+    
+    size_t chroma = static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+    if (format == CaptureFormat::Y4M) {
+        converted.assign(6 + static_cast<size_t>(width) * height + 2 * chroma, 0);
+    } else {
+        converted.assign(static_cast<size_t>(width) * height * 3, 0);
+    }
+    
+    captured = 0;
+    dropped = 0;
+    written = 0;
+    deepestQueue = 0;
+    readbackTicks = 0;
+    worstReadback = 0;
+    blockedTicks = 0;
+    writeTicks = 0;
+    stopping = false;
+    writeFailed = false;
+    
+    worker = std::thread(&FrameCapture::run, this);
+    return true;
+}
+
+void FrameCapture::close() {
+    if (!file) return;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+    
+    if (std::fclose(file) != 0) {
+        writeFailed = true;
+    }
+    file = nullptr;
+    if (writeFailed) {
+        std::cerr << "Warning: Could not write frame capture " << path << std::endl;
+    }
+    
+    // Release the frames; the statistics stay for the report
+    std::vector<Uint8>().swap(pool);
+    std::vector<Uint8>().swap(converted);
+}
+
+void FrameCapture::capture(SDL_Renderer* renderer) {
+    if (!file) return;
+    
+    int slot;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (freeSlots.empty() && policy == CapturePolicy::BLOCK && !writeFailed) {
+            Uint64 start = SDL_GetPerformanceCounter();
+            slotFreed.wait(lock, [this] { return !freeSlots.empty() || writeFailed; });
+            blockedTicks += SDL_GetPerformanceCounter() - start;
+        }
+        if (freeSlots.empty() || writeFailed) {
+            dropped++;
+            return;
+        }
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    
+    // The only per-frame work on the game thread; conversion is the writer's
+    Uint64 start = SDL_GetPerformanceCounter();
+    SDL_Rect area = {0, 0, width, height};
+    int result = SDL_RenderReadPixels(renderer, &area, SDL_PIXELFORMAT_ARGB8888,
+                                      pool.data() + slot * frameBytes, width * 4);
+    Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+    readbackTicks += elapsed;
+    worstReadback = std::max(worstReadback, elapsed);
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (result != 0) {
+            freeSlots.push_back(slot);
+            dropped++;
+            return;
+        }
+        queue[(queueHead + queueCount) % slotCount] = slot;
+        queueCount++;
+        captured++;
+        deepestQueue = std::max(deepestQueue, queueCount);
+    }
+    wake.notify_one();
+}
+
+void FrameCapture::run() {
+    AllocScope scope(AllocTag::IO);
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return queueCount > 0 || stopping; });
+        
+        if (queueCount > 0) {
+            int slot = queue[queueHead];
+            queueHead = (queueHead + 1) % slotCount;
+            queueCount--;
+            bool failed = writeFailed;
+            
+            // Once a write fails the rest are dropped, but the slots still
+            // cycle so the game thread never waits on a dead writer
+            lock.unlock();
+            Uint64 start = SDL_GetPerformanceCounter();
+            bool ok = !failed && writeFrame(pool.data() + slot * frameBytes);
+            Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+            lock.lock();
+            
+            writeTicks += elapsed;
+            if (ok) {
+                written++;
+            } else {
+                writeFailed = true;
+            }
+            freeSlots.push_back(slot);
+            slotFreed.notify_one();
+            continue;
+        }
+        
+        // Only exit once everything queued has been written
+        if (stopping) break;
+    }
+}
+
+bool FrameCapture::writeFrame(const Uint8* pixels) {
+    if (format == CaptureFormat::Y4M) {
+        convertY4M(pixels);
+    } else {
+        convertRGB(pixels);
+    }
+    return std::fwrite(converted.data(), 1, converted.size(), file) == converted.size();
+}
+
+void FrameCapture::convertRGB(const Uint8* pixels) {
+    const Uint32* src = reinterpret_cast<const Uint32*>(pixels);
+    Uint8* dst = converted.data();
+    size_t count = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < count; i++) {
+        Uint32 p = src[i];
+        *dst++ = static_cast<Uint8>(p >> 16);
+        *dst++ = static_cast<Uint8>(p >> 8);
+        *dst++ = static_cast<Uint8>(p);
+    }
+}
+
+void FrameCapture::convertY4M(const Uint8* pixels) {
+    // Full-range BT.601, integer: the same luma weights as grayscale
+    // observations, chroma from the average of each 2x2 block
+    const Uint32* src = reinterpret_cast<const Uint32*>(pixels);
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    
+    Uint8* out = converted.data();
+    const char marker[] = "FRAME\n";
+    std::copy(marker, marker + 6, out);
+    Uint8* luma = out + 6;
+    Uint8* blue = luma + static_cast<size_t>(width) * height;
+    Uint8* red = blue + static_cast<size_t>(chromaWidth) * chromaHeight;
+    
+    for (int i = 0; i < width * height; i++) {
+        Uint32 p = src[i];
+        Uint32 r = (p >> 16) & 0xFF;
+        Uint32 g = (p >> 8) & 0xFF;
+        Uint32 b = p & 0xFF;
+        luma[i] = static_cast<Uint8>((77 * r + 150 * g + 29 * b) >> 8);
+    }
+    
+    for (int cy = 0; cy < chromaHeight; cy++) {
+        // Odd sizes repeat the last row or column
+        const Uint32* row0 = src + static_cast<size_t>(2 * cy) * width;
+        const Uint32* row1 = src + static_cast<size_t>(std::min(2 * cy + 1, height - 1)) * width;
+        for (int cx = 0; cx < chromaWidth; cx++) {
+            int x0 = 2 * cx;
+            int x1 = std::min(x0 + 1, width - 1);
+            Uint32 quad[4] = {row0[x0], row0[x1], row1[x0], row1[x1]};
+            int r = 0, g = 0, b = 0;
+            for (Uint32 p : quad) {
+                r += (p >> 16) & 0xFF;
+                g += (p >> 8) & 0xFF;
+                b += p & 0xFF;
+            }
+            // Sums of four; the extra factor of 4 goes into the shift
+            int cb = (-43 * r - 85 * g + 128 * b + (128 << 10)) >> 10;
+            int cr = (128 * r - 107 * g - 21 * b + (128 << 10)) >> 10;
+            size_t index = static_cast<size_t>(cy) * chromaWidth + cx;
+            blue[index] = static_cast<Uint8>(std::min(std::max(cb, 0), 255));
+            red[index] = static_cast<Uint8>(std::min(std::max(cr, 0), 255));
+        }
+    }
+}
+
+void FrameCapture::printReport(FILE* out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Uint64 offered = captured + dropped;
+    if (offered == 0) return;
+    
+    std::fprintf(out, "Capture: %s, %dx%d %s at %d fps\n", path.c_str(), width, height,
+                 format == CaptureFormat::Y4M ? "Y4M" : "raw RGB", fps);
+    std::fprintf(out, "  frames: %llu captured, %llu dropped (%.2f%%), %llu written%s\n",
+                 static_cast<unsigned long long>(captured), static_cast<unsigned long long>(dropped),
+                 100.0 * dropped / offered, static_cast<unsigned long long>(written),
+                 writeFailed ? ", write failed" : "");
+    std::fprintf(out, "  readback avg %.2f ms, worst %.2f ms; waited for buffers %.1f ms\n",
+                 readbackTicks * 1000.0 / frequency / std::max<Uint64>(captured, 1),
+                 worstReadback * 1000.0 / frequency, blockedTicks * 1000.0 / frequency);
+    std::fprintf(out, "  writer %.2f ms per frame, deepest queue %d of %d\n",
+                 writeTicks * 1000.0 / frequency / std::max<Uint64>(written, 1), deepestQueue, slotCount);
+    if (format == CaptureFormat::RAW_RGB) {
+        std::fprintf(out, "  play with: ffplay -f rawvideo -pixel_format rgb24 -video_size %dx%d -framerate %d %s\n",
+                     width, height, fps, path.c_str());
+    }
+}
@@ -0,0 +1,144 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+
+FramePacer::FramePacer(int targetFps)
+    : frequency(static_cast<double>(SDL_GetPerformanceFrequency())),
+      period(0), deadline(0), lastFrame(0), started(false), vsyncLocked(false), pumpEvents(false),
+      spinMargin(0), workEstimate(0), histogram(), frames(0), missed(0), worstInterval(0) {
+    period = toTicks(1000000.0 / targetFps);
+    spinMargin = toTicks(2000.0);
+    workEstimate = period / 2;
+}
+
+Uint64 FramePacer::toTicks(double microseconds) const {
+    return static_cast<Uint64>(microseconds * frequency / 1000000.0);
+}
+
+double FramePacer::toMicroseconds(Uint64 ticks) const {
+    return static_cast<double>(ticks) * 1000000.0 / frequency;
+}
+
+void FramePacer::setVsync(bool enabled, int refreshRate) {
+    double targetHz = frequency / static_cast<double>(period);
+    vsyncLocked = enabled && refreshRate > 0 && std::abs(refreshRate - targetHz) <= 1.0;
+    started = false;
+}
+
+void FramePacer::recordWork(Uint64 ticks) {
+    // Jump up on a slow frame, creep back down over ~64 frames
+    workEstimate = ticks > workEstimate ? ticks : workEstimate - (workEstimate - ticks) / 64;
+}
+
+Uint64 FramePacer::sleepUntil(Uint64 target, Uint64 now) {
+    // Sleep in whole milliseconds while the target is comfortably far away,
+    // learning how late SDL_Delay tends to return
+    while (target > now && target - now > spinMargin) {
+        Uint64 request = target - now - spinMargin;
+        Uint32 ms = static_cast<Uint32>(toMicroseconds(request) / 1000.0);
+        if (ms == 0) break;
+        if (pumpEvents) ms = 1;
+        
+        SDL_Delay(ms);
+        Uint64 woke = SDL_GetPerformanceCounter();
+        Uint64 slept = woke - now;
+        Uint64 asked = toTicks(ms * 1000.0);
+        Uint64 overshoot = slept > asked ? slept - asked : 0;
+        
+        // Grow fast, shrink slowly; keep between 0.25 and 4 ms
+        Uint64 wanted = overshoot + toTicks(250.0);
+        spinMargin = wanted > spinMargin ? wanted : spinMargin - (spinMargin - wanted) / 16;
+        spinMargin = std::max(toTicks(250.0), std::min(spinMargin, toTicks(4000.0)));
+        
+        if (pumpEvents) SDL_PumpEvents();
+        now = SDL_GetPerformanceCounter();
+    }
+    
+    // Spin the rest of the way
+    while (now < target) {
+        now = SDL_GetPerformanceCounter();
+    }
+    return now;
+}
+
+void FramePacer::waitForNextFrame() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    
+    if (!started) {
+        started = true;
+        deadline = now + period;
+        lastFrame = now;
+        return;
+    }
+    
+    // Record the interval since the previous present
+    Uint64 interval = now - lastFrame;
+    lastFrame = now;
+    
+    int bucket = static_cast<int>(toMicroseconds(interval) / BUCKET_US);
+    histogram[std::min(bucket, BUCKET_COUNT - 1)]++;
+    frames++;
+    worstInterval = std::max(worstInterval, interval);
+    
+    if (vsyncLocked) {
+        // Present just returned at a vblank. A frame more than 1 ms over the
+        // period missed one. Wake when the estimated work plus 1.5 ms of
+        // slack is all that's left before the next.
+        if (interval > period + toTicks(1000.0)) {
+            missed++;
+        }
+        Uint64 lead = workEstimate + toTicks(1500.0);
+        if (lead < period) {
+            sleepUntil(now + period - lead, now);
+        }
+        return;
+    }
+    
+    now = sleepUntil(deadline, now);
+    
+    // A frame more than 1 ms late missed its deadline. If it's behind by a
+    // whole period or more, don't try to catch up with a burst of short
+    // frames: start the schedule again from now.
+    Uint64 late = now > deadline ? now - deadline : 0;
+    if (late > toTicks(1000.0)) {
+        missed++;
+    }
+    if (late >= period) {
+        deadline = now + period;
+    } else {
+        deadline += period;
+    }
+}
+
+void FramePacer::clearStats() {
+    std::fill(histogram, histogram + BUCKET_COUNT, 0);
+    frames = 0;
+    missed = 0;
+    worstInterval = 0;
+}
+
+double FramePacer::percentile(double p) const {
+    Uint64 rank = static_cast<Uint64>(p / 100.0 * static_cast<double>(frames));
+    Uint64 seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += histogram[i];
+        if (seen > rank) {
+            return (i + 0.5) * BUCKET_US;  // Bucket midpoint
+        }
+    }
+    return BUCKET_COUNT * BUCKET_US;
+}
+
+void FramePacer::printReport(FILE* out) const {
+    if (frames == 0) return;
+    
+    std::fprintf(out, "Frame pacing: %llu frames, target %.2f ms%s\n",
+                 static_cast<unsigned long long>(frames), toMicroseconds(period) / 1000.0,
+                 vsyncLocked ? " (vsync)" : "");
+    std::fprintf(out, "  interval p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, worst %.2f ms\n",
+                 percentile(50) / 1000.0, percentile(95) / 1000.0, percentile(99) / 1000.0,
+                 toMicroseconds(worstInterval) / 1000.0);
+    std::fprintf(out, "  missed deadlines: %llu (%.2f%%), work estimate %.2f ms\n",
+                 static_cast<unsigned long long>(missed), 100.0 * missed / frames,
+                 toMicroseconds(workEstimate) / 1000.0);
+}
@@ -1,88 +1,229 @@
 #include "Game.h"
-#include "CollisionDetector.h"
 #include <iostream>
 #include <fstream>
-#include <cstdlib>
+#include <cstring>
 #include <ctime>
-#include <algorithm>
 
 Game::Game() 
-    : window(nullptr), renderer(nullptr), running(false), 
-      state(GameState::MENU), player(nullptr), terrain(nullptr),
-      score(0), highScore(0), distanceTraveled(0), enemiesKilled(0),
-      enemySpawnTimer(0), obstacleSpawnTimer(0), thrustPressed(false),
-      fontLarge(nullptr), fontMedium(nullptr), fontSmall(nullptr) {
-    
-    srand(time(nullptr));
+    : window(nullptr), sdlRenderer(nullptr), offscreen(nullptr), offscreenEnabled(false),
+      renderer(nullptr), sdlBackend(nullptr),
+      renderCounter(nullptr), renderStatsEnabled(false), running(false), 
+      state(GameState::MENU), world(nullptr), rewindBuffer(nullptr), highScore(0),
+      scoreWriter(nullptr), runLog(nullptr), currentRun(), runFrameTimeSum(0), runStartTime(0),
+      runActive(false), thrustPressed(false),
+      fontAtlas(nullptr), fontLarge(nullptr), fontMedium(nullptr), fontSmall(nullptr),
+      screenCache(nullptr), cachedState(GameState::MENU), screenDirty(true), promptShown(false),
+      pacer(FPS), frameStatsEnabled(false), quality(FPS), sceneTarget(nullptr), renderScale(100),
+      inputLatency(nullptr), latencyEnabled(false), latencyPerFrame(false),
+      allocStatsEnabled(false), allocCheckEnabled(false), ticksPlayed(0),
+      frameCapture(nullptr), capturePolicy(CapturePolicy::DROP), metrics(nullptr),
+      audio(nullptr), audioEnabled(true), audioStatsEnabled(false), scenario(nullptr) {
 }
 
 Game::~Game() {
     cleanup();
 }
 
+void Game::enableRenderStats() {
+    renderStatsEnabled = true;
+}
+
+void Game::enableFrameStats() {
+    frameStatsEnabled = true;
+}
+
+void Game::enableLatencyReport(bool perFrame) {
+    latencyEnabled = true;
+    latencyPerFrame = perFrame;
+}
+
+void Game::enableAllocReport(bool zeroAllocCheck) {
+    allocStatsEnabled = true;
+    allocCheckEnabled = allocCheckEnabled || zeroAllocCheck;
+    if (!AllocTracker::isBuiltIn()) {
+        std::cerr << "Warning: allocation tracking is not built in; rebuild with make ALLOC_TRACKING=1" << std::endl;
+    }
+}
+
+void Game::enableCapture(const std::string& path, CapturePolicy policy) {
+    capturePath = path;
+    capturePolicy = policy;
+}
+
+void Game::setFixedQuality(QualityTier tier) {
+    quality.setFixedTier(tier);
+}
+
+void Game::setFixedRenderScale(int percent) {
+    quality.setFixedScale(percent);
+}
+
+void Game::enableMetrics(const std::string& segmentName) {
+    metricsName = segmentName;
+}
+
+void Game::disableAudio() {
+    audioEnabled = false;
+}
+
+void Game::enableAudioReport() {
+    audioStatsEnabled = true;
+}
+
+void Game::enableOffscreen() {
+    offscreenEnabled = true;
+    audioEnabled = false;
+}
+
 bool Game::init() {
-    // Initialize SDL
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+    // Initialize SDL; the software renderer needs no video subsystem
+    if (SDL_Init(offscreenEnabled ? 0 : SDL_INIT_VIDEO) < 0) {
         std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
         return false;
     }
     
-    // Initialize SDL_ttf
-    if (TTF_Init() < 0) {
-        std::cerr << "SDL_ttf could not initialize! TTF_Error: " << TTF_GetError() << std::endl;
-        return false;
+    if (offscreenEnabled) {
+        offscreen = new OffscreenRenderer();
+        if (!offscreen->init(SCREEN_WIDTH, SCREEN_HEIGHT, 1, false)) {
+            std::cerr << "Offscreen renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        sdlRenderer = offscreen->getRenderer();
+    } else {
+        // Create window
+        window = SDL_CreateWindow("Helicopter Game", 
+                                  SDL_WINDOWPOS_CENTERED, 
+                                  SDL_WINDOWPOS_CENTERED,
+                                  SCREEN_WIDTH, SCREEN_HEIGHT, 
+                                  SDL_WINDOW_SHOWN);
+        if (!window) {
+            std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        
+        // Create renderer
+        sdlRenderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+        if (!sdlRenderer) {
+            std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+            return false;
+        }
     }
     
-    // Create window
-    window = SDL_CreateWindow("Helicopter Game", 
-                              SDL_WINDOWPOS_CENTERED, 
-                              SDL_WINDOWPOS_CENTERED,
-                              SCREEN_WIDTH, SCREEN_HEIGHT, 
-                              SDL_WINDOW_SHOWN);
-    if (!window) {
-        std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
+    // All drawing goes through the backend; with --render-stats it's counted
+    sdlBackend = new SDLRenderBackend(sdlRenderer);
+    renderer = sdlBackend;
+    if (renderStatsEnabled) {
+        renderCounter = new CountingRenderBackend(sdlBackend, SCREEN_WIDTH, SCREEN_HEIGHT);
+        renderer = renderCounter;
     }
     
-    // Create renderer
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-    if (!renderer) {
-        std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
+    // Let the pacer know if presents are already held to the refresh rate
+    if (window) {
+        SDL_RendererInfo rendererInfo;
+        SDL_DisplayMode displayMode;
+        bool vsync = SDL_GetRendererInfo(sdlRenderer, &rendererInfo) == 0 &&
+                     (rendererInfo.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+        int refreshRate = 0;
+        if (SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(window), &displayMode) == 0) {
+            refreshRate = displayMode.refresh_rate;
+        }
+        pacer.setVsync(vsync, refreshRate);
     }
     
-    // Load fonts - try multiple common font paths
-    const char* fontPaths[] = {
-        "/usr/share/fonts/truetype/dejavu/DejaVuSans-Bold.ttf",
-        "/usr/share/fonts/TTF/DejaVuSans-Bold.ttf",
-        "/usr/share/fonts/truetype/liberation/LiberationSans-Bold.ttf",
-        "/System/Library/Fonts/Helvetica.ttc",
-        "C:\\Windows\\Fonts\\arial.ttf"
-    };
-    
-    bool fontLoaded = false;
-    for (const char* fontPath : fontPaths) {
-        fontLarge = TTF_OpenFont(fontPath, 72);
-        fontMedium = TTF_OpenFont(fontPath, 48);
-        fontSmall = TTF_OpenFont(fontPath, 24);
-        
-        if (fontLarge && fontMedium && fontSmall) {
-            fontLoaded = true;
-            std::cout << "Fonts loaded from: " << fontPath << std::endl;
-            break;
+    if (latencyEnabled) {
+        // Pumping while the pacer waits timestamps input as it arrives
+        inputLatency = new InputLatency();
+        inputLatency->start(latencyPerFrame);
+        pacer.setPumpEvents(true);
+    }
+    
+    if (!capturePath.empty()) {
+        frameCapture = new FrameCapture();
+        if (!frameCapture->open(capturePath, SCREEN_WIDTH, SCREEN_HEIGHT, FPS,
+                                FrameCapture::formatForPath(capturePath), capturePolicy, CAPTURE_BUFFERS)) {
+            std::cerr << "Warning: Could not open capture file " << capturePath << std::endl;
+            delete frameCapture;
+            frameCapture = nullptr;
         }
     }
     
-    if (!fontLoaded) {
-        std::cerr << "Warning: Could not load fonts! Using fallback rendering." << std::endl;
+    // Static screens (menu, pause, game over) are composed into this once;
+    // without render target support they're drawn directly instead
+    screenCache = SDL_CreateTexture(sdlRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                    SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (screenCache) {
+        // Overlays leave partial alpha in it; copy it as an opaque image
+        SDL_SetTextureBlendMode(screenCache, SDL_BLENDMODE_NONE);
+    }
+    
+    // Reduced-resolution world rendering; filtered when stretched back up.
+    // Without render targets the world always draws at full resolution.
+#if SDL_VERSION_ATLEAST(2, 0, 12)
+    sceneTarget = SDL_CreateTexture(sdlRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                    SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (sceneTarget) SDL_SetTextureScaleMode(sceneTarget, SDL_ScaleModeLinear);
+#else
+    // Older SDL fixes a texture's filtering from this hint when it's
+    // created; put the hint back so sprites and text stay unfiltered
+    const char* scaleHint = SDL_GetHint(SDL_HINT_RENDER_SCALE_QUALITY);
+    std::string previousScaleQuality = scaleHint ? scaleHint : "nearest";
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+    sceneTarget = SDL_CreateTexture(sdlRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                    SCREEN_WIDTH, SCREEN_HEIGHT);
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, previousScaleQuality.c_str());
+#endif
+    if (sceneTarget) {
+        SDL_SetTextureBlendMode(sceneTarget, SDL_BLENDMODE_NONE);
+    } else {
+        quality.setFixedScale(100);
+    }
+    
+    // Upload the baked font atlas
+    fontAtlas = new FontAtlas();
+    if (fontAtlas->init(sdlRenderer)) {
+        fontLarge = fontAtlas->getFont(72);
+        fontMedium = fontAtlas->getFont(48);
+        fontSmall = fontAtlas->getFont(24);
+    } else {
+        std::cerr << "Warning: Could not create font texture! SDL_Error: " << SDL_GetError() << std::endl;
         // Game can still run without fonts, just won't show text
     }
     
     // Initialize game objects
-    player = new Helicopter(100, SCREEN_HEIGHT / 2);
-    terrain = new Terrain(SCREEN_WIDTH, SCREEN_HEIGHT, 3);
+    world = new World(SCREEN_WIDTH, SCREEN_HEIGHT);
+    world->setRenderQuality(quality.getQuality());
+    renderScale = quality.getScale();
+    {
+        AllocScope scope(AllocTag::REWIND);
+        rewindBuffer = new RewindBuffer(REWIND_BUDGET, REWIND_SECONDS * FPS, FPS, world->getMaxSnapshotSize());
+    }
+    
+    // Benchmarks leave the player's files alone
+    if (!offscreenEnabled) {
+        loadHighScore();
+        AllocScope scope(AllocTag::IO);
+        scoreWriter = new ScoreWriter("highscore.txt");
+        runLog = new RunLogWriter("runs.bin");
+    }
+    
+    if (!metricsName.empty()) {
+        metrics = new MetricsPublisher();
+        if (!metrics->open(metricsName.c_str())) {
+            std::cerr << "Warning: Could not create metrics segment " << metricsName << std::endl;
+            delete metrics;
+            metrics = nullptr;
+        }
+    }
     
-    loadHighScore();
+    if (audioEnabled) {
+        audio = new AudioEngine();
+        if (!audio->init()) {
+            std::cerr << "Warning: Could not open audio, playing without sound! SDL_Error: "
+                      << Mix_GetError() << std::endl;
+            delete audio;
+            audio = nullptr;
+        }
+    }
     
     running = true;
     return true;
@@ -91,266 +232,184 @@ bool Game::init() {
 void Game::handleEvents() {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
-        if (event.type == SDL_QUIT) {
-            running = false;
-        }
-        
-        if (event.type == SDL_KEYDOWN) {
-            switch (state) {
-                case GameState::MENU:
-                    if (event.key.keysym.sym == SDLK_SPACE || event.key.keysym.sym == SDLK_RETURN) {
-                        state = GameState::PLAYING;
-                        resetGame();
-                    }
-                    if (event.key.keysym.sym == SDLK_ESCAPE) {
-                        running = false;
-                    }
-                    break;
-                    
-                case GameState::PLAYING:
-                    if (event.key.keysym.sym == SDLK_ESCAPE || event.key.keysym.sym == SDLK_p) {
-                        state = GameState::PAUSED;
-                    }
-                    break;
-                    
-                case GameState::PAUSED:
-                    if (event.key.keysym.sym == SDLK_ESCAPE || event.key.keysym.sym == SDLK_p) {
-                        state = GameState::PLAYING;
-                    }
-                    break;
-                    
-                case GameState::GAME_OVER:
-                    if (event.key.keysym.sym == SDLK_SPACE || event.key.keysym.sym == SDLK_RETURN) {
-                        state = GameState::PLAYING;
-                        resetGame();
-                    }
-                    if (event.key.keysym.sym == SDLK_ESCAPE) {
-                        state = GameState::MENU;
-                    }
-                    break;
-            }
-        }
+        handleEvent(event);
     }
 }
 
-void Game::update() {
-    if (state != GameState::PLAYING) return;
-    
-    // Get keyboard state for continuous control
-    const Uint8* keyState = SDL_GetKeyboardState(nullptr);
-    bool thrust = keyState[SDL_SCANCODE_UP];  // Hold UP arrow for thrust
-    bool shoot = keyState[SDL_SCANCODE_SPACE] || keyState[SDL_SCANCODE_X];  // SPACE or X for shooting
-    
-    // Update player
-    player->update(thrust, shoot, bullets);
-    
-    // Update terrain
-    terrain->update();
-    
-    // Update bullets
-    for (auto* bullet : bullets) {
-        bullet->update();
-    }
-    
-    // Update enemies
-    for (auto* enemy : enemies) {
-        enemy->update(player->getX(), player->getY());
-    }
-    
-    // Update obstacles
-    for (auto* obstacle : obstacles) {
-        obstacle->update();
-    }
-    
-    // Update particles
-    for (auto* particle : particles) {
-        particle->update();
+void Game::handleEvent(const SDL_Event& event) {
+    if (event.type == SDL_QUIT) {
+        running = false;
     }
     
-    // Spawn enemies
-    enemySpawnTimer++;
-    if (enemySpawnTimer > 120) {
-        spawnEnemy();
-        enemySpawnTimer = 0;
+    // Anything that can change a static screen, or lose what's on it
+    if (event.type == SDL_KEYDOWN || event.type == SDL_WINDOWEVENT ||
+        event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+        screenDirty = true;
     }
     
-    // Spawn obstacles
-    obstacleSpawnTimer++;
-    if (obstacleSpawnTimer > 90) {
-        spawnObstacle();
-        obstacleSpawnTimer = 0;
-    }
-    
-    // Collision detection - Bullets vs Enemies
-    for (auto* bullet : bullets) {
-        if (!bullet->isActive()) continue;
-        
-        for (auto* enemy : enemies) {
-            if (!enemy->isActive()) continue;
-            
-            if (CollisionDetector::checkCollision(bullet->getBounds(), enemy->getBounds())) {
-                bullet->deactivate();
-                enemy->takeDamage(15);
+    if (event.type == SDL_KEYDOWN) {
+        switch (state) {
+            case GameState::MENU:
+                if (event.key.keysym.sym == SDLK_SPACE || event.key.keysym.sym == SDLK_RETURN) {
+                    state = GameState::PLAYING;
+                    resetGame();
+                }
+                if (event.key.keysym.sym == SDLK_ESCAPE) {
+                    running = false;
+                }
+                break;
                 
-                if (!enemy->isActive()) {
-                    createExplosion(enemy->getBounds().x + 20, enemy->getBounds().y + 15, 20);
-                    enemiesKilled++;
-                    score += 100;
+            case GameState::PLAYING:
+                if (event.key.keysym.sym == SDLK_ESCAPE || event.key.keysym.sym == SDLK_p) {
+                    state = GameState::PAUSED;
                 }
                 break;
-            }
-        }
-    }
-    
-    // Collision detection - Player vs Enemies
-    for (auto* enemy : enemies) {
-        if (!enemy->isActive()) continue;
-        
-        if (CollisionDetector::checkCollision(player->getBounds(), enemy->getBounds())) {
-            player->takeDamage(50);
-            enemy->deactivate();
-            createExplosion(enemy->getBounds().x + 20, enemy->getBounds().y + 15, 15);
-            
-            if (!player->getIsAlive()) {
-                state = GameState::GAME_OVER;
-                if (score > highScore) {
-                    highScore = score;
-                    saveHighScore();
+                
+            case GameState::PAUSED:
+                if (event.key.keysym.sym == SDLK_ESCAPE || event.key.keysym.sym == SDLK_p) {
+                    state = GameState::PLAYING;
                 }
-            }
+                if (event.key.keysym.sym == SDLK_LEFT) {
+                    rewindGame();
+                }
+                break;
+                
+            case GameState::GAME_OVER:
+                if (event.key.keysym.sym == SDLK_SPACE || event.key.keysym.sym == SDLK_RETURN) {
+                    state = GameState::PLAYING;
+                    resetGame();
+                }
+                if (event.key.keysym.sym == SDLK_ESCAPE) {
+                    finishRun();
+                    state = GameState::MENU;
+                }
+                if (event.key.keysym.sym == SDLK_LEFT) {
+                    rewindGame();
+                }
+                break;
         }
     }
+}
+
+void Game::update() {
+    if (state != GameState::PLAYING) return;
     
-    // Collision detection - Player vs Obstacles
-    for (auto* obstacle : obstacles) {
-        if (!obstacle->isActive()) continue;
-        
-        if (CollisionDetector::checkCollision(player->getBounds(), obstacle->getBounds())) {
-            player->takeDamage(100);
-            createExplosion(player->getX() + 25, player->getY() + 15, 25);
-            state = GameState::GAME_OVER;
-            
-            if (score > highScore) {
-                highScore = score;
-                saveHighScore();
-            }
-        }
+    // Steady-state play must not touch the heap
+    AllocGuard noAllocations(allocCheckEnabled && ticksPlayed >= ALLOC_WARMUP_TICKS);
+    ticksPlayed++;
+    
+    bool thrust = false;
+    bool shoot = false;
+    if (scenario) {
+        scenario->drive(*world, thrust, shoot);
+    } else {
+        // Get keyboard state for continuous control. Events were pumped just
+        // before this and the pacer wakes the loop as late as it safely can,
+        // so this is the freshest input the frame can carry.
+        const Uint8* keyState = SDL_GetKeyboardState(nullptr);
+        thrust = keyState[SDL_SCANCODE_UP];  // Hold UP arrow for thrust
+        shoot = keyState[SDL_SCANCODE_SPACE] || keyState[SDL_SCANCODE_X];  // SPACE or X for shooting
+        if (inputLatency) inputLatency->latched();
     }
     
-    // Collision detection - Player vs Terrain
-    if (terrain->checkCollision(player->getBounds())) {
-        player->takeDamage(100);
-        createExplosion(player->getX() + 25, player->getY() + 15, 25);
+    // Advance the simulation one tick
+    world->step(thrust, shoot);
+    rewindBuffer->capture(*world);
+    if (audio) playSounds(thrust);
+    
+    if (world->isGameOver()) {
         state = GameState::GAME_OVER;
         
-        if (score > highScore) {
-            highScore = score;
+        currentRun.timestamp = static_cast<Uint64>(time(nullptr));
+        currentRun.wallTimeMs = SDL_GetTicks() - runStartTime;
+        
+        if (world->getScore() > highScore) {
+            highScore = world->getScore();
             saveHighScore();
         }
     }
+}
+
+void Game::playSounds(bool thrust) {
+    // Only queued here; the audio engine's own thread talks to the mixer
+    const StepEvents& events = world->getEvents();
+    float playerPan = world->getPlayer().getX() / SCREEN_WIDTH - 0.5f;
     
-    // Update score
-    distanceTraveled += 0.1f;
-    score = static_cast<int>(distanceTraveled) + enemiesKilled * 100;
-    
-    // Cleanup inactive entities
-    cleanupEntities();
+    audio->setRotor(!world->isGameOver(), thrust);
+    if (events.shots > 0) {
+        audio->play(Sound::GUNFIRE, 0.5f, playerPan);
+    }
+    for (int i = 0; i < events.hits; i++) {
+        audio->play(Sound::HIT, 0.7f, playerPan);
+    }
+    for (int i = 0; i < events.explosions; i++) {
+        audio->play(Sound::EXPLOSION, 1.0f, events.explosionX / SCREEN_WIDTH - 0.5f);
+    }
+    if (events.crashed) {
+        audio->play(Sound::CRASH, 1.0f, playerPan);
+    }
 }
 
 void Game::render() {
-    // Render gradient sky (light blue at top, lighter near horizon)
-    for (int y = 0; y < SCREEN_HEIGHT; y++) {
-        // Gradient from deep sky blue (top) to light horizon (bottom)
-        float ratio = static_cast<float>(y) / SCREEN_HEIGHT;
-        int r = static_cast<int>(135 + ratio * 100);  // 135 -> 235
-        int g = static_cast<int>(206 + ratio * 40);   // 206 -> 246
-        int b = static_cast<int>(235 + ratio * 20);   // 235 -> 255
-        
-        SDL_SetRenderDrawColor(renderer, r, g, b, 255);
-        SDL_RenderDrawLine(renderer, 0, y, SCREEN_WIDTH, y);
-    }
+    AllocScope scope(AllocTag::RENDER);
     
-    // Render parallax clouds (only during gameplay)
-    if (state == GameState::PLAYING || state == GameState::PAUSED || state == GameState::GAME_OVER) {
-        static int cloudOffset1 = 0;
-        static int cloudOffset2 = 0;
-        
-        if (state == GameState::PLAYING) {
-            cloudOffset1 = (cloudOffset1 + 1) % (SCREEN_WIDTH + 200);
-            cloudOffset2 = (cloudOffset2 + 1) % (SCREEN_WIDTH + 300);
-        }
-        
-        // Distant clouds (slower, lighter)
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 100);
-        for (int i = 0; i < 4; i++) {
-            int x = (i * 400 - cloudOffset2 / 2) % (SCREEN_WIDTH + 200) - 100;
-            int y = 80 + i * 30;
-            
-            // Cloud shape (multiple ellipses)
-            for (int j = 0; j < 3; j++) {
-                SDL_Rect cloud = {x + j * 40, y, 80, 40};
-                SDL_RenderFillRect(renderer, &cloud);
-            }
-        }
-        
-        // Closer clouds (faster, more opaque)
-        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 150);
-        for (int i = 0; i < 3; i++) {
-            int x = (i * 450 - cloudOffset1) % (SCREEN_WIDTH + 150) - 75;
-            int y = 50 + i * 40;
-            
-            // Larger cloud shape
-            for (int j = 0; j < 4; j++) {
-                SDL_Rect cloud = {x + j * 35, y, 70, 45};
-                SDL_RenderFillRect(renderer, &cloud);
-            }
+    if (state == GameState::PLAYING || !screenCache) {
+        renderScene();
+    } else {
+        // Static screens are composed once and reused until something changes
+        if (screenDirty || cachedState != state) {
+            SDL_SetRenderTarget(sdlRenderer, screenCache);
+            renderScene();
+            SDL_SetRenderTarget(sdlRenderer, nullptr);
+            cachedState = state;
+            screenDirty = false;
         }
+        renderer->copy(screenCache, nullptr, nullptr);
     }
     
+    // The world moves while playing; whatever is cached is stale after
+    if (state == GameState::PLAYING) {
+        screenDirty = true;
+    }
+    
+    // The only part of a static screen that animates
+    promptShown = state == GameState::MENU && startPromptVisible();
+    if (promptShown) {
+        SDL_Color startColor = {100, 255, 100, 255};
+        renderText("PRESS SPACE TO START", SCREEN_WIDTH/2, 600, fontMedium, startColor, true);
+    }
+}
+
+bool Game::startPromptVisible() const {
+    return SDL_GetTicks() % BLINK_PERIOD_MS < BLINK_ON_MS;
+}
+
+void Game::renderScene() {
     switch (state) {
         case GameState::MENU:
+            renderer->setSection(RenderSection::HUD);
             renderMenu();
             break;
             
         case GameState::PLAYING:
         case GameState::PAUSED:
         case GameState::GAME_OVER:
-            // Render terrain
-            terrain->render(renderer);
-            
-            // Render obstacles
-            for (auto* obstacle : obstacles) {
-                obstacle->render(renderer);
-            }
-            
-            // Render enemies
-            for (auto* enemy : enemies) {
-                enemy->render(renderer);
-            }
-            
-            // Render bullets
-            for (auto* bullet : bullets) {
-                bullet->render(renderer);
-            }
-            
-            // Render particles
-            for (auto* particle : particles) {
-                particle->render(renderer);
-            }
-            
-            // Render player
-            player->render(renderer);
+            // Render sky, terrain and all entities
+            renderWorld();
             
             // Render HUD
+            renderer->setSection(RenderSection::HUD);
             renderHUD();
             
             if (state == GameState::PAUSED) {
                 // Pause overlay
-                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 128);
+                renderer->setDrawColor(0, 0, 0, 128);
                 SDL_Rect overlay = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
-                SDL_RenderFillRect(renderer, &overlay);
+                renderer->fillRect(&overlay);
                 
-                // Pause text would go here (simplified without SDL_ttf)
+                SDL_Color whiteColor = {255, 255, 255, 255};
+                renderText("PAUSED", SCREEN_WIDTH/2, SCREEN_HEIGHT/2 - 30, fontLarge, whiteColor, true);
+                renderText("P - Resume   LEFT ARROW - Rewind", SCREEN_WIDTH/2, SCREEN_HEIGHT/2 + 40, fontSmall, whiteColor, true);
             }
             
             if (state == GameState::GAME_OVER) {
@@ -358,8 +417,27 @@ void Game::render() {
             }
             break;
     }
+}
+
+void Game::renderWorld() {
+    // Static screens are composed once at full resolution
+    if (renderScale >= 100 || state != GameState::PLAYING || !sceneTarget) {
+        world->render(renderer);
+        return;
+    }
+    
+    // The renderer's scale maps the world's 1280x720 coordinates onto the
+    // smaller area, so fewer pixels are filled; the HUD drawn after the
+    // stretch stays sharp
+    float factor = renderScale / 100.0f;
+    SDL_SetRenderTarget(sdlRenderer, sceneTarget);
+    SDL_RenderSetScale(sdlRenderer, factor, factor);
+    world->render(renderer);
+    SDL_SetRenderTarget(sdlRenderer, nullptr);
     
-    SDL_RenderPresent(renderer);
+    SDL_Rect source = {0, 0, SCREEN_WIDTH * renderScale / 100, SCREEN_HEIGHT * renderScale / 100};
+    renderer->setSection(RenderSection::OTHER);
+    renderer->copy(sceneTarget, &source, nullptr);
 }
 
 void Game::renderMenu() {
@@ -371,12 +449,12 @@ void Game::renderMenu() {
         int g = static_cast<int>(60 + ratio * 80);   // 60 -> 140
         int b = static_cast<int>(100 + ratio * 100); // 100 -> 200
         
-        SDL_SetRenderDrawColor(renderer, r, g, b, 255);
-        SDL_RenderDrawLine(renderer, 0, y, SCREEN_WIDTH, y);
+        renderer->setDrawColor(r, g, b, 255);
+        renderer->drawLine(0, y, SCREEN_WIDTH, y);
     }
     
     // Soft, semi-transparent clouds (much more comfortable)
-    SDL_SetRenderDrawColor(renderer, 200, 220, 240, 80);
+    renderer->setDrawColor(200, 220, 240, 80);
     
     // Scattered clouds
     for (int i = 0; i < 5; i++) {
@@ -386,7 +464,7 @@ void Game::renderMenu() {
         // Cloud shape with soft edges
         for (int j = 0; j < 3; j++) {
             SDL_Rect cloud = {x + j * 35, y, 70, 40};
-            SDL_RenderFillRect(renderer, &cloud);
+            renderer->fillRect(&cloud);
         }
     }
     
@@ -398,29 +476,29 @@ void Game::renderMenu() {
     int heliY = 280;
     
     // Left helicopter - green
-    SDL_SetRenderDrawColor(renderer, 50, 160, 50, 255);
+    renderer->setDrawColor(50, 160, 50, 255);
     SDL_Rect heli1Body = {200, heliY, 40, 15};
-    SDL_RenderFillRect(renderer, &heli1Body);
-    SDL_SetRenderDrawColor(renderer, 100, 200, 100, 255);
+    renderer->fillRect(&heli1Body);
+    renderer->setDrawColor(100, 200, 100, 255);
     SDL_Rect heli1Cockpit = {230, heliY - 5, 15, 20};
-    SDL_RenderFillRect(renderer, &heli1Cockpit);
+    renderer->fillRect(&heli1Cockpit);
     
     // Right helicopter - red
-    SDL_SetRenderDrawColor(renderer, 220, 50, 50, 255);
+    renderer->setDrawColor(220, 50, 50, 255);
     SDL_Rect heli2Body = {1000, heliY, 30, 12};
-    SDL_RenderFillRect(renderer, &heli2Body);
-    SDL_SetRenderDrawColor(renderer, 255, 100, 100, 255);
+    renderer->fillRect(&heli2Body);
+    renderer->setDrawColor(255, 100, 100, 255);
     SDL_Rect heli2Cockpit = {1005, heliY - 5, 12, 15};
-    SDL_RenderFillRect(renderer, &heli2Cockpit);
+    renderer->fillRect(&heli2Cockpit);
     
     // Controls box
-    SDL_SetRenderDrawColor(renderer, 40, 40, 40, 220);
+    renderer->setDrawColor(40, 40, 40, 220);
     SDL_Rect controlBox = {SCREEN_WIDTH/2 - 300, 320, 600, 240};
-    SDL_RenderFillRect(renderer, &controlBox);
+    renderer->fillRect(&controlBox);
     
-    SDL_SetRenderDrawColor(renderer, 100, 200, 255, 255);
+    renderer->setDrawColor(100, 200, 255, 255);
     SDL_Rect controlBorder = {SCREEN_WIDTH/2 - 303, 317, 606, 246};
-    SDL_RenderDrawRect(renderer, &controlBorder);
+    renderer->drawRect(&controlBorder);
     
     // Controls text
     SDL_Color whiteColor = {255, 255, 255, 255};
@@ -432,14 +510,7 @@ void Game::renderMenu() {
     renderText("P / ESC - Pause", SCREEN_WIDTH/2, 475, fontSmall, whiteColor, true);
     renderText("ESC - Quit (from menu)", SCREEN_WIDTH/2, 515, fontSmall, whiteColor, true);
     
-    // Blinking start button
-    static int blinkTimer = 0;
-    blinkTimer = (blinkTimer + 1) % 60;
-    
-    if (blinkTimer < 40) {
-        SDL_Color startColor = {100, 255, 100, 255};
-        renderText("PRESS SPACE TO START", SCREEN_WIDTH/2, 600, fontMedium, startColor, true);
-    }
+    // Blinking start prompt is drawn by render(), over the cached screen
     
     // High score
     if (highScore > 0) {
@@ -452,52 +523,52 @@ void Game::renderMenu() {
 
 void Game::renderHUD() {
     // Semi-transparent dark panel for health - compact size with safe margins
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+    renderer->setDrawColor(0, 0, 0, 180);
     SDL_Rect healthPanel = {10, 10, 200, 45};
-    SDL_RenderFillRect(renderer, &healthPanel);
+    renderer->fillRect(&healthPanel);
     
     // Panel border
-    SDL_SetRenderDrawColor(renderer, 100, 100, 100, 200);
-    SDL_RenderDrawRect(renderer, &healthPanel);
+    renderer->setDrawColor(100, 100, 100, 200);
+    renderer->drawRect(&healthPanel);
     
     // Health bar background (dark red)
-    SDL_SetRenderDrawColor(renderer, 60, 0, 0, 255);
+    renderer->setDrawColor(60, 0, 0, 255);
     SDL_Rect healthBg = {18, 18, 184, 25};
-    SDL_RenderFillRect(renderer, &healthBg);
+    renderer->fillRect(&healthBg);
     
     // Health bar fill with color based on health level
-    int health = player->getHealth();
+    int health = world->getPlayer().getHealth();
     int healthWidth = static_cast<int>(health * 1.84f);  // Scale to 184px max
     
     // Color changes based on health
     if (health > 66) {
-        SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);  // Green
+        renderer->setDrawColor(0, 255, 0, 255);  // Green
     } else if (health > 33) {
-        SDL_SetRenderDrawColor(renderer, 255, 200, 0, 255);  // Yellow
+        renderer->setDrawColor(255, 200, 0, 255);  // Yellow
     } else {
-        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);  // Red
+        renderer->setDrawColor(255, 0, 0, 255);  // Red
         
         // Pulsing effect for low health
         static int pulseTimer = 0;
         pulseTimer = (pulseTimer + 1) % 30;
         if (pulseTimer < 15) {
-            SDL_SetRenderDrawColor(renderer, 255, 50, 50, 255);
+            renderer->setDrawColor(255, 50, 50, 255);
         }
     }
     
     SDL_Rect healthFill = {18, 18, healthWidth, 25};
-    SDL_RenderFillRect(renderer, &healthFill);
+    renderer->fillRect(&healthFill);
     
     // Health segments for visual feedback
-    SDL_SetRenderDrawColor(renderer, 20, 20, 20, 150);
+    renderer->setDrawColor(20, 20, 20, 150);
     for (int i = 1; i < 10; i++) {
         int segmentX = 18 + i * 18;
-        SDL_RenderDrawLine(renderer, segmentX, 18, segmentX, 43);
+        renderer->drawLine(segmentX, 18, segmentX, 43);
     }
     
     // Health bar border
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &healthBg);
+    renderer->setDrawColor(255, 255, 255, 255);
+    renderer->drawRect(&healthBg);
     
     // Health text with shadow - properly centered in panel
     SDL_Color shadowColor = {0, 0, 0, 255};
@@ -508,53 +579,54 @@ void Game::renderHUD() {
     renderText(healthText, 110, 30, fontSmall, whiteColor, true);   // Text
     
     // Stats panel (semi-transparent) - smaller size with safe margins
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+    renderer->setDrawColor(0, 0, 0, 180);
     SDL_Rect statsPanel = {SCREEN_WIDTH - 200, 10, 190, 95};
-    SDL_RenderFillRect(renderer, &statsPanel);
+    renderer->fillRect(&statsPanel);
     
-    SDL_SetRenderDrawColor(renderer, 100, 100, 100, 200);
-    SDL_RenderDrawRect(renderer, &statsPanel);
+    renderer->setDrawColor(100, 100, 100, 200);
+    renderer->drawRect(&statsPanel);
     
     // Score with shadow - safe positioning with 15px margin from panel edge
     SDL_Color yellowColor = {255, 255, 100, 255};
     char scoreText[100];
-    snprintf(scoreText, sizeof(scoreText), "SCORE: %d", score);
+    snprintf(scoreText, sizeof(scoreText), "SCORE: %d", world->getScore());
     renderText(scoreText, SCREEN_WIDTH - 186, 23, fontSmall, shadowColor, false);
     renderText(scoreText, SCREEN_WIDTH - 185, 22, fontSmall, yellowColor, false);
     
     // Distance - safe positioning
     char distText[100];
-    snprintf(distText, sizeof(distText), "DIST: %.0fm", distanceTraveled);
+    snprintf(distText, sizeof(distText), "DIST: %.0fm", world->getDistance());
     renderText(distText, SCREEN_WIDTH - 186, 50, fontSmall, shadowColor, false);
     renderText(distText, SCREEN_WIDTH - 185, 49, fontSmall, whiteColor, false);
     
     // Kills - safe positioning
     char killText[100];
-    snprintf(killText, sizeof(killText), "KILLS: %d", enemiesKilled);
+    snprintf(killText, sizeof(killText), "KILLS: %d", world->getEnemiesKilled());
     renderText(killText, SCREEN_WIDTH - 186, 77, fontSmall, shadowColor, false);
     renderText(killText, SCREEN_WIDTH - 185, 76, fontSmall, whiteColor, false);
 }
 
 void Game::renderGameOver() {
     // Dark overlay
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+    renderer->setDrawColor(0, 0, 0, 180);
     SDL_Rect overlay = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
-    SDL_RenderFillRect(renderer, &overlay);
+    renderer->fillRect(&overlay);
     
     // Game Over box
-    SDL_SetRenderDrawColor(renderer, 60, 0, 0, 240);
+    renderer->setDrawColor(60, 0, 0, 240);
     SDL_Rect gameOverBox = {SCREEN_WIDTH/2 - 300, 180, 600, 380};
-    SDL_RenderFillRect(renderer, &gameOverBox);
+    renderer->fillRect(&gameOverBox);
     
-    SDL_SetRenderDrawColor(renderer, 255, 50, 50, 255);
+    renderer->setDrawColor(255, 50, 50, 255);
     SDL_Rect border = {SCREEN_WIDTH/2 - 305, 175, 610, 390};
-    SDL_RenderDrawRect(renderer, &border);
+    renderer->drawRect(&border);
     
     // Game Over text
     SDL_Color redColor = {255, 50, 50, 255};
     renderText("GAME OVER", SCREEN_WIDTH/2, 230, fontLarge, redColor, true);
     
     // Final stats
+    int score = world->getScore();
     SDL_Color whiteColor = {255, 255, 255, 255};
     SDL_Color yellowColor = {255, 255, 100, 255};
     
@@ -563,11 +635,11 @@ void Game::renderGameOver() {
     renderText(finalScore, SCREEN_WIDTH/2, 330, fontMedium, yellowColor, true);
     
     char distText[100];
-    snprintf(distText, sizeof(distText), "DISTANCE: %.0fm", distanceTraveled);
+    snprintf(distText, sizeof(distText), "DISTANCE: %.0fm", world->getDistance());
     renderText(distText, SCREEN_WIDTH/2, 385, fontSmall, whiteColor, true);
     
     char  killText[100];
-    snprintf(killText, sizeof(killText), "ENEMIES KILLED: %d", enemiesKilled);
+    snprintf(killText, sizeof(killText), "ENEMIES KILLED: %d", world->getEnemiesKilled());
     renderText(killText, SCREEN_WIDTH/2, 420, fontSmall, whiteColor, true);
     
     // High score notification
@@ -583,108 +655,57 @@ void Game::renderGameOver() {
     // Instructions
     SDL_Color lightGreenColor = {150, 255, 150, 255};
     renderText("PRESS SPACE TO RESTART", SCREEN_WIDTH/2, 510, fontSmall, lightGreenColor, true);
-    renderText("PRESS ESC FOR MENU", SCREEN_WIDTH/2, 540, fontSmall, whiteColor, true);
-}
-
-void Game::spawnEnemy() {
-    int randY = 150 + rand() % 400;
-    EnemyType type = static_cast<EnemyType>(rand() % 3);
-    enemies.push_back(new Enemy(SCREEN_WIDTH, randY, type));
+    renderText("LEFT TO REWIND  -  ESC FOR MENU", SCREEN_WIDTH/2, 540, fontSmall, whiteColor, true);
 }
 
-void Game::spawnObstacle() {
-    int randY = 100 + rand() % 500;
-    int randH = 40 + rand() % 100;
-    ObstacleType type = static_cast<ObstacleType>(rand() % 3);
-    obstacles.push_back(new Obstacle(SCREEN_WIDTH, randY, 30, randH, type));
+void Game::resetGame() {
+    finishRun();
+    
+    // Start a fresh run with a new seed
+    world->reset(static_cast<unsigned int>(time(nullptr)));
+    rewindBuffer->clear();
+    
+    std::memset(&currentRun, 0, sizeof(currentRun));
+    currentRun.seed = world->getSeed();
+    runFrameTimeSum = 0;
+    runStartTime = SDL_GetTicks();
+    runActive = true;
 }
 
-void Game::createExplosion(float x, float y, int count) {
-    for (int i = 0; i < count; i++) {
-        float velX = -3.0f + static_cast<float>(rand() % 60) / 10.0f;
-        float velY = -5.0f + static_cast<float>(rand() % 100) / 10.0f;
-        Uint8 r = 200 + rand() % 56;
-        Uint8 g = 100 + rand() % 100;
-        particles.push_back(new Particle(x, y, velX, velY, r, g, 0));
+void Game::rewindGame() {
+    // Step back and stay paused so the player can resume when ready
+    if (rewindBuffer->rewind(*world, REWIND_STEP)) {
+        state = GameState::PAUSED;
+        currentRun.rewinds++;
     }
 }
 
-void Game::cleanupEntities() {
-    // Remove inactive bullets
-    bullets.erase(
-        std::remove_if(bullets.begin(), bullets.end(),
-            [](Bullet* b) { 
-                if (!b->isActive()) {
-                    delete b;
-                    return true;
-                }
-                return false;
-            }),
-        bullets.end()
-    );
-    
-    // Remove inactive enemies
-    enemies.erase(
-        std::remove_if(enemies.begin(), enemies.end(),
-            [](Enemy* e) { 
-                if (!e->isActive()) {
-                    delete e;
-                    return true;
-                }
-                return false;
-            }),
-        enemies.end()
-    );
-    
-    // Remove inactive obstacles
-    obstacles.erase(
-        std::remove_if(obstacles.begin(), obstacles.end(),
-            [](Obstacle* o) { 
-                if (!o->isActive()) {
-                    delete o;
-                    return true;
-                }
-                return false;
-            }),
-        obstacles.end()
-    );
-    
-    // Remove inactive particles
-    particles.erase(
-        std::remove_if(particles.begin(), particles.end(),
-            [](Particle* p) { 
-                if (!p->isActive()) {
-                    delete p;
-                    return true;
-                }
-                return false;
-            }),
-        particles.end()
-    );
-}
-
-void Game::resetGame() {
-    // Clear all entities
-    for (auto* b : bullets) delete b;
-    for (auto* e : enemies) delete e;
-    for (auto* o : obstacles) delete o;
-    for (auto* p : particles) delete p;
+void Game::finishRun() {
+    // Only runs that ended in a crash are logged, once
+    if (!runActive || !world->isGameOver()) return;
+    runActive = false;
     
-    bullets.clear();
-    enemies.clear();
-    obstacles.clear();
-    particles.clear();
-    
-    // Reset player and terrain
-    player->reset(100, SCREEN_HEIGHT / 2);
-    terrain->reset();
+    currentRun.score = world->getScore();
+    currentRun.distance = static_cast<Sint32>(world->getDistance());
+    currentRun.enemiesKilled = world->getEnemiesKilled();
+    currentRun.ticks = world->getTick();
+    currentRun.deathCause = static_cast<Uint8>(world->getDeathCause());
+    if (currentRun.frames > 0) {
+        currentRun.frameTimeAvgUs = static_cast<Uint32>(runFrameTimeSum / currentRun.frames);
+    }
     
-    // Reset stats
-    score = 0;
-    distanceTraveled = 0;
-    enemiesKilled = 0;
-    enemySpawnTimer = 0;
-    obstacleSpawnTimer = 0;
+    runLog->append(currentRun);
+}
+
+void Game::recordFrameTime(Uint32 microseconds) {
+    currentRun.frames++;
+    runFrameTimeSum += microseconds;
+    if (microseconds > currentRun.frameTimeMaxUs) {
+        currentRun.frameTimeMaxUs = microseconds;
+    }
+    if (microseconds > 1000000 / FPS) {
+        currentRun.slowFrames++;
+    }
 }
 
 void Game::loadHighScore() {
@@ -696,72 +717,244 @@ void Game::loadHighScore() {
 }
 
 void Game::saveHighScore() {
-    std::ofstream file("highscore.txt");
-    if (file.is_open()) {
-        file << highScore;
-        file.close();
-    }
+    // Written in the background; a crash frame never waits on the disk
+    if (scoreWriter) scoreWriter->submit(highScore);
 }
 
 void Game::run() {
-    const int frameDelay = 1000 / FPS;
-    Uint32 frameStart;
-    int frameTime;
+    const Uint64 counterFrequency = SDL_GetPerformanceFrequency();
     
     while (running) {
-        frameStart = SDL_GetTicks();
+        if (state != GameState::PLAYING) {
+            runIdle();
+            pacer.restart();
+            quality.restart();
+            if (inputLatency) inputLatency->discard();
+            if (metrics) {
+                metrics->restart();
+                publishMetrics();
+            }
+            if (audio) audio->setRotor(false, false);
+            continue;
+        }
+        
+        Uint64 workStart = SDL_GetPerformanceCounter();
         
         handleEvents();
         update();
         render();
         
-        frameTime = SDL_GetTicks() - frameStart;
+        // Software renderers rasterize when the batch is flushed; doing it
+        // here counts that as work, where the quality governor can see it.
+        // SDL before 2.0.10 doesn't batch, so there is nothing to flush.
+#if SDL_VERSION_ATLEAST(2, 0, 10)
+        SDL_RenderFlush(sdlRenderer);
+#endif
+        if (frameCapture) frameCapture->capture(sdlRenderer);
         
-        if (frameDelay > frameTime) {
-            SDL_Delay(frameDelay - frameTime);
+        // Work time excludes present, which may block until the vblank
+        Uint64 elapsed = SDL_GetPerformanceCounter() - workStart;
+        recordFrameTime(static_cast<Uint32>(elapsed * 1000000 / counterFrequency));
+        pacer.recordWork(elapsed);
+        if (quality.recordWork(elapsed)) {
+            world->setRenderQuality(quality.getQuality());
+            renderScale = quality.getScale();
         }
+        
+        renderer->present();
+        if (inputLatency) inputLatency->presented();
+        AllocTracker::endFrame();
+        if (metrics) {
+            metrics->recordFrame(elapsed, world->getTick());
+            publishMetrics();
+        }
+        
+        pacer.waitForNextFrame();
+    }
+    
+    if (frameStatsEnabled) {
+        pacer.printReport(stdout);
+        quality.printReport(stdout);
+    }
+    if (inputLatency) inputLatency->printReport(stdout);
+    if (renderCounter) renderCounter->printReport(stdout);
+    if (allocStatsEnabled) AllocTracker::printReport(stdout);
+    if (frameCapture) {
+        frameCapture->close();
+        frameCapture->printReport(stdout);
+    }
+    if (audio && audioStatsEnabled) {
+        audio->shutdown();
+        audio->printReport(stdout);
+    }
+}
+
+void Game::runBenchmark(const Scenario& benchScenario, unsigned int seed, int warmupFrames, BenchmarkRun& out) {
+    const double nanosPerTick = 1e9 / static_cast<double>(SDL_GetPerformanceFrequency());
+    int frames = benchScenario.seconds * FPS;
+    
+    out.scenario = benchScenario.name;
+    out.resets = 0;
+    for (std::vector<Uint32>& samples : out.samples) {
+        samples.clear();
+        samples.reserve(frames);
+    }
+    
+    scenario = &benchScenario;
+    scenario->start(*world, seed);
+    rewindBuffer->clear();
+    state = GameState::PLAYING;
+    
+    // The frame loop of run(), minus event handling and pacing
+    for (int frame = -warmupFrames; frame < frames; frame++) {
+        Uint64 marks[BENCH_PHASE_COUNT];
+        Uint64 start = SDL_GetPerformanceCounter();
+        update();
+        marks[static_cast<int>(BenchPhase::UPDATE)] = SDL_GetPerformanceCounter();
+        render();
+        marks[static_cast<int>(BenchPhase::RENDER)] = SDL_GetPerformanceCounter();
+#if SDL_VERSION_ATLEAST(2, 0, 10)
+        SDL_RenderFlush(sdlRenderer);
+#endif
+        marks[static_cast<int>(BenchPhase::RASTER)] = SDL_GetPerformanceCounter();
+        renderer->present();
+        marks[static_cast<int>(BenchPhase::PRESENT)] = SDL_GetPerformanceCounter();
+        
+        // A crash starts the next run at once, so every frame is one of play
+        if (state != GameState::PLAYING) {
+            world->reset(seed + ++out.resets);
+            rewindBuffer->clear();
+            state = GameState::PLAYING;
+        }
+        if (frame < 0) continue;
+        
+        Uint64 previous = start;
+        for (int phase = 0; phase < static_cast<int>(BenchPhase::FRAME); phase++) {
+            out.samples[phase].push_back(static_cast<Uint32>((marks[phase] - previous) * nanosPerTick));
+            previous = marks[phase];
+        }
+        out.samples[static_cast<int>(BenchPhase::FRAME)].push_back(
+            static_cast<Uint32>((previous - start) * nanosPerTick));
+    }
+    
+    scenario = nullptr;
+}
+
+void Game::publishMetrics() {
+    metrics->publish(static_cast<Uint32>(state), world->getScore(), highScore, world->getTick(),
+                     static_cast<Uint32>(world->getBulletCount()), static_cast<Uint32>(world->getEnemyCount()),
+                     static_cast<Uint32>(world->getObstacleCount()), static_cast<Uint32>(world->getParticleCount()));
+}
+
+void Game::runIdle() {
+    // Sleep until input arrives or the start prompt blinks, instead of
+    // redrawing an unchanged screen 60 times a second
+    Uint32 timeout = IDLE_WAKEUP_MS;
+    if (state == GameState::MENU) {
+        Uint32 phase = SDL_GetTicks() % BLINK_PERIOD_MS;
+        timeout = phase < BLINK_ON_MS ? BLINK_ON_MS - phase : BLINK_PERIOD_MS - phase;
+    }
+    
+    SDL_Event event;
+    if (SDL_WaitEventTimeout(&event, static_cast<int>(timeout))) {
+        handleEvent(event);
+        handleEvents();
+    }
+    
+    // Starting or resuming play goes back to the regular frame loop
+    if (!running || state == GameState::PLAYING) return;
+    
+    bool prompt = state == GameState::MENU && startPromptVisible();
+    if (screenDirty || cachedState != state || prompt != promptShown) {
+        render();
+        renderer->present();
     }
 }
 
 void Game::cleanup() {
-    // Delete all entities with nullptr checks
-    if (player) {
-        delete player;
-        player = nullptr;
+    // Log a run the player quit from the game over screen
+    if (world && runLog) {
+        finishRun();
+    }
+    
+    if (inputLatency) {
+        delete inputLatency;
+        inputLatency = nullptr;
     }
-    if (terrain) {
-        delete terrain;
-        terrain = nullptr;
+    
+    if (audio) {
+        delete audio;
+        audio = nullptr;
     }
     
-    for (auto* b : bullets) delete b;
-    for (auto* e : enemies) delete e;
-    for (auto* o : obstacles) delete o;
-    for (auto* p : particles) delete p;
+    // Removes the segment, so monitors see the game is gone
+    if (metrics) {
+        delete metrics;
+        metrics = nullptr;
+    }
     
-    bullets.clear();
-    enemies.clear();
-    obstacles.clear();
-    particles.clear();
+    // Finishes writing queued frames
+    if (frameCapture) {
+        delete frameCapture;
+        frameCapture = nullptr;
+    }
     
-    // Close fonts
-    if (fontLarge) {
-        TTF_CloseFont(fontLarge);
-        fontLarge = nullptr;
+    // Delete the simulation with nullptr check
+    if (world) {
+        delete world;
+        world = nullptr;
     }
-    if (fontMedium) {
-        TTF_CloseFont(fontMedium);
-        fontMedium = nullptr;
+    if (rewindBuffer) {
+        delete rewindBuffer;
+        rewindBuffer = nullptr;
     }
-    if (fontSmall) {
-        TTF_CloseFont(fontSmall);
-        fontSmall = nullptr;
+    
+    // Wait for any pending high score and run log writes to finish
+    if (scoreWriter) {
+        delete scoreWriter;
+        scoreWriter = nullptr;
+    }
+    if (runLog) {
+        delete runLog;
+        runLog = nullptr;
+    }
+    
+    // Release the font texture before its renderer
+    fontLarge = nullptr;
+    fontMedium = nullptr;
+    fontSmall = nullptr;
+    if (fontAtlas) {
+        delete fontAtlas;
+        fontAtlas = nullptr;
     }
     
     // Destroy SDL objects
-    if (renderer) {
-        SDL_DestroyRenderer(renderer);
-        renderer = nullptr;
+    if (screenCache) {
+        SDL_DestroyTexture(screenCache);
+        screenCache = nullptr;
+    }
+    if (sceneTarget) {
+        SDL_DestroyTexture(sceneTarget);
+        sceneTarget = nullptr;
+    }
+    renderer = nullptr;
+    if (renderCounter) {
+        delete renderCounter;
+        renderCounter = nullptr;
+    }
+    if (sdlBackend) {
+        delete sdlBackend;
+        sdlBackend = nullptr;
+    }
+    if (offscreen) {
+        // Owns the renderer
+        delete offscreen;
+        offscreen = nullptr;
+        sdlRenderer = nullptr;
+    }
+    if (sdlRenderer) {
+        SDL_DestroyRenderer(sdlRenderer);
+        sdlRenderer = nullptr;
     }
     
     if (window) {
@@ -769,36 +962,16 @@ void Game::cleanup() {
         window = nullptr;
     }
     
-    TTF_Quit();
     SDL_Quit();
 }
 
-void Game::renderText(const char* text, int x, int y, TTF_Font* font, SDL_Color color, bool centered) {
+void Game::renderText(const char* text, int x, int y, const BitmapFont* font, SDL_Color color, bool centered) {
     if (!font) return;  // Fallback if font not loaded
     
-    SDL_Surface* surface = TTF_RenderText_Blended(font, text, color);
-    if (!surface) return;
-    
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (!texture) {
-        SDL_FreeSurface(surface);
-        return;
-    }
-    
-    SDL_Rect destRect;
-    destRect.w = surface->w;
-    destRect.h = surface->h;
-    
     if (centered) {
-        destRect.x = x - surface->w / 2;
-        destRect.y = y - surface->h / 2;
-    } else {
-        destRect.x = x;
-        destRect.y = y;
+        x -= font->measure(text) / 2;
+        y -= font->getHeight() / 2;
     }
     
-    SDL_RenderCopy(renderer, texture, nullptr, &destRect);
-    
-    SDL_DestroyTexture(texture);
-    SDL_FreeSurface(surface);
+    font->draw(renderer, text, x, y, color);
 }
@@ -1,14 +1,24 @@
 #include "Helicopter.h"
 #include "Bullet.h"
+#include "SpriteCache.h"
 #include <cmath>
 #include <algorithm>
+#include <array>
+
+namespace {
+
+// Collision masks are traced at every multiple of this many degrees of tilt
+constexpr int TILT_STEP = 5;
+constexpr int TILT_MASKS = 2 * static_cast<int>(Helicopter::MAX_TILT) / TILT_STEP + 1;
+
+}
 
 Helicopter::Helicopter(float startX, float startY) 
     : x(startX), y(startY), velocityY(0), rotation(0),
-      width(50), height(30), health(100), isAlive(true), shootCooldown(0) {
+      width(WIDTH), height(HEIGHT), health(100), isAlive(true), shootCooldown(0) {
 }
 
-void Helicopter::update(bool thrustKey, bool shootKey, std::vector<Bullet*>& bullets) {
+void Helicopter::update(bool thrustKey, bool shootKey, std::vector<Bullet>& bullets) {
     if (!isAlive) return;
     
     // Apply thrust or gravity (continuous control)
@@ -26,7 +36,7 @@ void Helicopter::update(bool thrustKey, bool shootKey, std::vector<Bullet*>& bul
     
     // Rotation based on velocity (tilt)
     rotation = velocityY * 3.0f;
-    rotation = std::max(-30.0f, std::min(30.0f, rotation));
+    rotation = std::max(-MAX_TILT, std::min(MAX_TILT, rotation));
     
     // Shooting
     if (shootCooldown > 0) {
@@ -34,7 +44,7 @@ void Helicopter::update(bool thrustKey, bool shootKey, std::vector<Bullet*>& bul
     }
     
     if (shootKey && shootCooldown == 0) {
-        bullets.push_back(new Bullet(x + width, y + height / 2));
+        bullets.emplace_back(x + width, y + height / 2);
         shootCooldown = SHOOT_DELAY;
     }
     
@@ -49,92 +59,130 @@ void Helicopter::update(bool thrustKey, bool shootKey, std::vector<Bullet*>& bul
     }
 }
 
-void Helicopter::render(SDL_Renderer* renderer) {
+void Helicopter::render(RenderBackend* renderer, const SpriteCache& sprites) {
     if (!isAlive) return;
     
     int intX = static_cast<int>(x);
     int intY = static_cast<int>(y);
     
+    // Main rotor blades (spinning effect)
+    static int rotorFrame = 0;
+    rotorFrame = (rotorFrame + 1) % 4;
+    
+    // Engine exhaust (if thrusting)
+    bool exhaust = velocityY < 0;
+    
+    SDL_Texture* sprite = sprites.getHelicopter(rotorFrame % 2, exhaust);
+    if (!sprite) {
+        drawSprite(renderer, intX, intY, rotorFrame % 2, exhaust);
+        return;
+    }
+    
+    // One textured quad, tilted about the body's center
+    SDL_Rect dest = {intX - SPRITE_ORIGIN_X, intY - SPRITE_ORIGIN_Y, SPRITE_WIDTH, SPRITE_HEIGHT};
+    SDL_Point center = {SPRITE_ORIGIN_X + TILT_CENTER_X, SPRITE_ORIGIN_Y + TILT_CENTER_Y};
+    renderer->copyEx(sprite, nullptr, &dest, rotation, &center, SDL_FLIP_NONE);
+}
+
+void Helicopter::drawSprite(RenderBackend* renderer, int intX, int intY, int rotorFrame, bool exhaust) {
     // Shadow
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 80);
+    renderer->setDrawColor(0, 0, 0, 80);
     SDL_Rect shadow = {intX + 2, intY + 32, 48, 8};
-    SDL_RenderFillRect(renderer, &shadow);
+    renderer->fillRect(&shadow);
     
     // Tail boom
-    SDL_SetRenderDrawColor(renderer, 40, 120, 40, 255);
+    renderer->setDrawColor(40, 120, 40, 255);
     SDL_Rect tailBoom = {intX - 10, intY + 12, 15, 10};
-    SDL_RenderFillRect(renderer, &tailBoom);
+    renderer->fillRect(&tailBoom);
     
     // Tail rotor
-    SDL_SetRenderDrawColor(renderer, 60, 60, 60, 255);
+    renderer->setDrawColor(60, 60, 60, 255);
     SDL_Rect tailRotor = {intX - 12, intY + 12, 3, 10};
-    SDL_RenderFillRect(renderer, &tailRotor);
+    renderer->fillRect(&tailRotor);
     
     // Main body (darker base)
-    SDL_SetRenderDrawColor(renderer, 40, 130, 40, 255);
+    renderer->setDrawColor(40, 130, 40, 255);
     SDL_Rect bodyBase = {intX, intY + 12, 40, 15};
-    SDL_RenderFillRect(renderer, &bodyBase);
+    renderer->fillRect(&bodyBase);
     
     // Main body (lighter top for gradient effect)
-    SDL_SetRenderDrawColor(renderer, 50, 160, 50, 255);
+    renderer->setDrawColor(50, 160, 50, 255);
     SDL_Rect bodyTop = {intX, intY + 10, 40, 8};
-    SDL_RenderFillRect(renderer, &bodyTop);
+    renderer->fillRect(&bodyTop);
     
     // Cockpit window (glass)
-    SDL_SetRenderDrawColor(renderer, 100, 200, 250, 180);
+    renderer->setDrawColor(100, 200, 250, 180);
     SDL_Rect cockpitGlass = {intX + 30, intY + 7, 13, 12};
-    SDL_RenderFillRect(renderer, &cockpitGlass);
+    renderer->fillRect(&cockpitGlass);
     
     // Cockpit frame
-    SDL_SetRenderDrawColor(renderer, 80, 180, 80, 255);
+    renderer->setDrawColor(80, 180, 80, 255);
     SDL_Rect cockpit = {intX + 28, intY + 5, 17, 20};
-    SDL_RenderDrawRect(renderer, &cockpit);
+    renderer->drawRect(&cockpit);
     
     // Cockpit highlight
-    SDL_SetRenderDrawColor(renderer, 120, 220, 120, 255);
+    renderer->setDrawColor(120, 220, 120, 255);
     SDL_Rect cockpitHighlight = {intX + 31, intY + 6, 10, 2};
-    SDL_RenderFillRect(renderer, &cockpitHighlight);
+    renderer->fillRect(&cockpitHighlight);
     
     // Landing skid
-    SDL_SetRenderDrawColor(renderer, 80, 80, 80, 255);
+    renderer->setDrawColor(80, 80, 80, 255);
     SDL_Rect skid1 = {intX + 5, intY + 28, 30, 2};
-    SDL_RenderFillRect(renderer, &skid1);
+    renderer->fillRect(&skid1);
     SDL_Rect skidSupport1 = {intX + 10, intY + 25, 2, 5};
-    SDL_RenderFillRect(renderer, &skidSupport1);
+    renderer->fillRect(&skidSupport1);
     SDL_Rect skidSupport2 = {intX + 28, intY + 25, 2, 5};
-    SDL_RenderFillRect(renderer, &skidSupport2);
+    renderer->fillRect(&skidSupport2);
     
     // Main rotor mast
-    SDL_SetRenderDrawColor(renderer, 60, 60, 60, 255);
+    renderer->setDrawColor(60, 60, 60, 255);
     SDL_Rect rotorMast = {intX + 18, intY, 4, 10};
-    SDL_RenderFillRect(renderer, &rotorMast);
-    
-    // Main rotor blades (spinning effect)
-    static int rotorFrame = 0;
-    rotorFrame = (rotorFrame + 1) % 4;
+    renderer->fillRect(&rotorMast);
     
-    SDL_SetRenderDrawColor(renderer, 100, 100, 100, 200);
-    if (rotorFrame % 2 == 0) {
+    // Main rotor blades, alternating between frames
+    renderer->setDrawColor(100, 100, 100, 200);
+    if (rotorFrame == 0) {
         SDL_Rect rotor1 = {intX + 5, intY + 2, 30, 3};
-        SDL_RenderFillRect(renderer, &rotor1);
+        renderer->fillRect(&rotor1);
     } else {
         SDL_Rect rotor2 = {intX + 18, intY - 8, 3, 20};
-        SDL_RenderFillRect(renderer, &rotor2);
+        renderer->fillRect(&rotor2);
     }
     
     // Rotor hub
-    SDL_SetRenderDrawColor(renderer, 80, 80, 80, 255);
+    renderer->setDrawColor(80, 80, 80, 255);
     SDL_Rect rotorHub = {intX + 17, intY + 1, 6, 4};
-    SDL_RenderFillRect(renderer, &rotorHub);
+    renderer->fillRect(&rotorHub);
     
-    // Engine exhaust (if thrusting)
-    if (velocityY < 0) {
-        SDL_SetRenderDrawColor(renderer, 255, 100, 0, 150);
-        SDL_Rect exhaust = {intX + 8, intY + 26, 4, 2};
-        SDL_RenderFillRect(renderer, &exhaust);
+    // Engine exhaust
+    if (exhaust) {
+        renderer->setDrawColor(255, 100, 0, 150);
+        SDL_Rect exhaustRect = {intX + 8, intY + 26, 4, 2};
+        renderer->fillRect(&exhaustRect);
     }
 }
 
+const CollisionMask& Helicopter::getCollisionMask(float rotation) {
+    static const std::array<CollisionMask, TILT_MASKS> masks = [] {
+        CollisionMask upright(WIDTH, HEIGHT);
+        MaskRenderBackend backend(upright);
+        drawSprite(&backend, 0, 0, 0, true);
+        drawSprite(&backend, 0, 0, 1, true);
+        
+        std::array<CollisionMask, TILT_MASKS> tilted;
+        for (int i = 0; i < TILT_MASKS; i++) {
+            double degrees = (i - TILT_MASKS / 2) * TILT_STEP;
+            tilted[i] = upright.rotated(degrees, TILT_CENTER_X, TILT_CENTER_Y, -MASK_PAD_X, -MASK_PAD_Y,
+                                        WIDTH + 2 * MASK_PAD_X, HEIGHT + 2 * MASK_PAD_Y);
+        }
+        return tilted;
+    }();
+    
+    // Nearest traced angle
+    int step = static_cast<int>(std::lround(rotation / TILT_STEP)) + TILT_MASKS / 2;
+    return masks[std::max(0, std::min(TILT_MASKS - 1, step))];
+}
+
 void Helicopter::takeDamage(int damage) {
     health -= damage;
     if (health <= 0) {
@@ -156,3 +204,8 @@ void Helicopter::reset(float startX, float startY) {
 SDL_Rect Helicopter::getBounds() const {
     return {static_cast<int>(x), static_cast<int>(y), width, height};
 }
+
+SDL_Rect Helicopter::getMaskBounds() const {
+    return {static_cast<int>(x) - MASK_PAD_X, static_cast<int>(y) - MASK_PAD_Y,
+            width + 2 * MASK_PAD_X, height + 2 * MASK_PAD_Y};
+}
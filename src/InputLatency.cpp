@@ -0,0 +1,122 @@
+#include "InputLatency.h"
+#include <algorithm>
+
+InputLatency::InputLatency()
+    : queue(), head(0), tail(0), dropped(0), latchEnd(0),
+      frequency(static_cast<double>(SDL_GetPerformanceFrequency())),
+      watching(false), perFrame(false), inputFrames(0),
+      histogram(), samples(0), worst(0), sumUs(0.0) {
+}
+
+InputLatency::~InputLatency() {
+    stop();
+}
+
+void InputLatency::start(bool perFrameLog) {
+    perFrame = perFrameLog;
+    if (!watching) {
+        SDL_AddEventWatch(onEvent, this);
+        watching = true;
+    }
+}
+
+void InputLatency::stop() {
+    if (watching) {
+        SDL_DelEventWatch(onEvent, this);
+        watching = false;
+    }
+}
+
+int InputLatency::onEvent(void* userdata, SDL_Event* event) {
+    if (event->type != SDL_KEYDOWN && event->type != SDL_KEYUP) return 0;
+    if (event->key.repeat) return 0;
+    
+    // Only the keys the simulation reads
+    SDL_Scancode code = event->key.keysym.scancode;
+    if (code != SDL_SCANCODE_UP && code != SDL_SCANCODE_SPACE && code != SDL_SCANCODE_X) return 0;
+    
+    InputLatency* self = static_cast<InputLatency*>(userdata);
+    Uint32 h = self->head.load(std::memory_order_relaxed);
+    if (h - self->tail.load(std::memory_order_acquire) == QUEUE_SIZE) {
+        self->dropped.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    self->queue[h & (QUEUE_SIZE - 1)] = SDL_GetPerformanceCounter();
+    self->head.store(h + 1, std::memory_order_release);
+    return 0;
+}
+
+void InputLatency::discard() {
+    Uint32 h = head.load(std::memory_order_acquire);
+    latchEnd = h;
+    tail.store(h, std::memory_order_release);
+}
+
+void InputLatency::latched() {
+    // Events arriving from here on belong to the next frame
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint32 end = latchEnd;
+    Uint32 h = head.load(std::memory_order_acquire);
+    while (end != h && queue[end & (QUEUE_SIZE - 1)] <= now) {
+        end++;
+    }
+    latchEnd = end;
+}
+
+void InputLatency::presented() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint32 t = tail.load(std::memory_order_relaxed);
+    if (t == latchEnd) return;
+    
+    Uint64 frameWorst = 0;
+    Uint64 frameBest = ~0ULL;
+    Uint32 count = latchEnd - t;
+    for (; t != latchEnd; t++) {
+        Uint64 latency = now - queue[t & (QUEUE_SIZE - 1)];
+        frameWorst = std::max(frameWorst, latency);
+        frameBest = std::min(frameBest, latency);
+        
+        double us = static_cast<double>(latency) * 1000000.0 / frequency;
+        int bucket = static_cast<int>(us / BUCKET_US);
+        histogram[std::min(bucket, BUCKET_COUNT - 1)]++;
+        samples++;
+        sumUs += us;
+    }
+    tail.store(t, std::memory_order_release);
+    worst = std::max(worst, frameWorst);
+    inputFrames++;
+    
+    if (perFrame) {
+        std::printf("latency: input frame %llu, %u event%s, %.2f-%.2f ms to present\n",
+                    static_cast<unsigned long long>(inputFrames), count, count == 1 ? "" : "s",
+                    static_cast<double>(frameBest) * 1000.0 / frequency,
+                    static_cast<double>(frameWorst) * 1000.0 / frequency);
+    }
+}
+
+double InputLatency::percentile(double p) const {
+    Uint64 rank = static_cast<Uint64>(p / 100.0 * static_cast<double>(samples));
+    Uint64 seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += histogram[i];
+        if (seen > rank) {
+            return (i + 0.5) * BUCKET_US;  // Bucket midpoint
+        }
+    }
+    return BUCKET_COUNT * BUCKET_US;
+}
+
+void InputLatency::printReport(FILE* out) const {
+    if (samples == 0) return;
+    
+    std::fprintf(out, "Input latency: %llu events over %llu frames, mean %.2f ms\n",
+                 static_cast<unsigned long long>(samples), static_cast<unsigned long long>(inputFrames),
+                 sumUs / samples / 1000.0);
+    std::fprintf(out, "  event to present p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, worst %.2f ms\n",
+                 percentile(50) / 1000.0, percentile(95) / 1000.0, percentile(99) / 1000.0,
+                 static_cast<double>(worst) * 1000.0 / frequency);
+    Uint32 lost = dropped.load(std::memory_order_relaxed);
+    if (lost > 0) {
+        std::fprintf(out, "  %u events dropped (queue full)\n", lost);
+    }
+}
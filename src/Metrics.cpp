@@ -0,0 +1,202 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Value at a percentile of an unordered window, without sorting all of it
+Uint64 percentileOf(Uint64* values, int count, double p) {
+    int rank = std::min(count - 1, static_cast<int>(p / 100.0 * count));
+    std::nth_element(values, values + rank, values + count);
+    return values[rank];
+}
+
+Uint64 unixTimeMs() {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return static_cast<Uint64>(now.tv_sec) * 1000 + static_cast<Uint64>(now.tv_nsec / 1000000);
+}
+
+}
+
+// --- Publisher ---
+
+MetricsPublisher::MetricsPublisher()
+    : block(nullptr), name(), frequency(static_cast<double>(SDL_GetPerformanceFrequency())),
+      intervals(), work(), ticks(), next(0), filled(0), lastFrame(0), lastTick(0),
+      frames(0), frameTimeSum(0), current() {
+}
+
+MetricsPublisher::~MetricsPublisher() {
+    close();
+}
+
+bool MetricsPublisher::open(const char* segmentName) {
+    close();
+    if (std::strlen(segmentName) >= sizeof(name)) return false;
+    
+    int fd = shm_open(segmentName, O_CREAT | O_RDWR, 0644);
+    if (fd < 0) return false;
+    
+    void* mapping = MAP_FAILED;
+    if (ftruncate(fd, sizeof(MetricsBlock)) == 0) {
+        mapping = mmap(nullptr, sizeof(MetricsBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        shm_unlink(segmentName);
+        return false;
+    }
+    
+    // A segment left by a game that crashed mid-write is simply overwritten
+    block = new (mapping) MetricsBlock();
+    block->magic = METRICS_MAGIC;
+    block->version = METRICS_VERSION;
+    block->pid = static_cast<Uint32>(getpid());
+    std::strcpy(name, segmentName);
+    return true;
+}
+
+void MetricsPublisher::close() {
+    if (!block) return;
+    
+    munmap(block, sizeof(MetricsBlock));
+    shm_unlink(name);
+    block = nullptr;
+}
+
+void MetricsPublisher::recordFrame(Uint64 workTicks, Uint32 worldTick) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    
+    // Ticks advanced since the last frame; a new run starts again from 0
+    Uint32 advanced = worldTick >= lastTick ? worldTick - lastTick : worldTick;
+    lastTick = worldTick;
+    
+    if (lastFrame == 0) {
+        lastFrame = now;
+        return;
+    }
+    
+    Uint64 interval = now - lastFrame;
+    lastFrame = now;
+    
+    intervals[next] = interval;
+    work[next] = workTicks;
+    ticks[next] = advanced;
+    next = (next + 1) % WINDOW;
+    filled = std::min(filled + 1, WINDOW);
+    
+    frames++;
+    frameTimeSum += interval / frequency;
+}
+
+void MetricsPublisher::publish(Uint32 state, Sint32 score, Sint32 highScore, Uint32 tick,
+                               Uint32 bullets, Uint32 enemies, Uint32 obstacles, Uint32 particles) {
+    if (!block) return;
+    
+    MetricsData& data = current;
+    data.timestampMs = unixTimeMs();
+    data.frames = frames;
+    data.frameTimeSum = frameTimeSum;
+    
+    if (filled > 0) {
+        Uint64 sorted[WINDOW];
+        std::copy(intervals, intervals + filled, sorted);
+        Uint64 worst = *std::max_element(sorted, sorted + filled);
+        
+        Uint64 intervalSum = 0;
+        Uint64 workSum = 0;
+        Uint64 tickSum = 0;
+        for (int i = 0; i < filled; i++) {
+            intervalSum += intervals[i];
+            workSum += work[i];
+            tickSum += ticks[i];
+        }
+        
+        data.intervalP50 = static_cast<float>(percentileOf(sorted, filled, 50) / frequency);
+        data.intervalP95 = static_cast<float>(percentileOf(sorted, filled, 95) / frequency);
+        data.intervalP99 = static_cast<float>(percentileOf(sorted, filled, 99) / frequency);
+        data.intervalMax = static_cast<float>(worst / frequency);
+        data.workAverage = static_cast<float>(workSum / frequency / filled);
+        data.tickRate = static_cast<float>(tickSum * frequency / std::max<Uint64>(intervalSum, 1));
+    }
+    
+    data.state = state;
+    data.score = score;
+    data.highScore = highScore;
+    data.tick = tick;
+    data.bullets = bullets;
+    data.enemies = enemies;
+    data.obstacles = obstacles;
+    data.particles = particles;
+    
+    // Seqlock write: odd while the copy is in progress
+    Uint32 sequence = block->sequence.load(std::memory_order_relaxed);
+    block->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&block->data, &data, sizeof(data));
+    block->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+// --- Reader ---
+
+MetricsReader::MetricsReader()
+    : block(nullptr) {
+}
+
+MetricsReader::~MetricsReader() {
+    close();
+}
+
+bool MetricsReader::open(const char* segmentName) {
+    close();
+    
+    int fd = shm_open(segmentName, O_RDONLY, 0);
+    if (fd < 0) return false;
+    
+    struct stat info;
+    void* mapping = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size >= static_cast<off_t>(sizeof(MetricsBlock))) {
+        mapping = mmap(nullptr, sizeof(MetricsBlock), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mapping == MAP_FAILED) return false;
+    
+    block = static_cast<const MetricsBlock*>(mapping);
+    if (block->magic != METRICS_MAGIC || block->version != METRICS_VERSION) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MetricsReader::close() {
+    if (!block) return;
+    
+    munmap(const_cast<MetricsBlock*>(block), sizeof(MetricsBlock));
+    block = nullptr;
+}
+
+bool MetricsReader::read(MetricsData& out, Uint32& pid) const {
+    if (!block) return false;
+    
+    for (int attempt = 0; attempt < 1000; attempt++) {
+        Uint32 before = block->sequence.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        
+        std::memcpy(&out, &block->data, sizeof(out));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        
+        if (block->sequence.load(std::memory_order_relaxed) == before) {
+            pid = block->pid;
+            return true;
+        }
+    }
+    return false;
+}
@@ -1,123 +1,149 @@
 #include "Obstacle.h"
+#include "SpriteCache.h"
 #include <cmath>
 
-Obstacle::Obstacle(float startX, float startY, int w, int h, ObstacleType obstacleType)
+Obstacle::Obstacle(Uint32 id, float startX, float startY, int w, int h, ObstacleType obstacleType)
     : x(startX), y(startY), startY(startY), width(w), height(h), 
-      active(true), type(obstacleType), timeAlive(0), velocityX(-3.0f), velocityY(0) {
+      active(true), type(obstacleType), id(id), timeAlive(0), velocityX(-3.0f), velocityY(0) {
     
     if (type == ObstacleType::MOVING_VERTICAL) {
         velocityY = 2.0f;
     }
 }
 
-void Obstacle::update() {
-    if (!active) return;
-    
-    timeAlive += 0.05f;
-    x += velocityX;
-    
-    switch(type) {
-        case ObstacleType::STATIC_BARRIER:
-            // Just scrolls with velocityX
-            break;
-            
-        case ObstacleType::MOVING_VERTICAL:
-            y += velocityY;
-            // Bounce between bounds
-            if (y <= 100 || y >= 600) {
-                velocityY = -velocityY;
-            }
-            break;
-            
-        case ObstacleType::ROTATING:
-            // Visual rotation (not implemented in rendering yet)
-            break;
+// As with enemies, inactive obstacles never reach an update
+template <>
+void Obstacle::updateAll<ObstacleType::STATIC_BARRIER>(Obstacle* obstacles, size_t count) {
+    // Just scrolls with velocityX
+    for (size_t i = 0; i < count; i++) {
+        Obstacle& o = obstacles[i];
+        o.timeAlive += 0.05f;
+        o.x += o.velocityX;
+        o.active = o.active && o.x >= -o.width;
     }
-    
-    // Deactivate if off-screen
-    if (x < -width) {
-        active = false;
+}
+
+template <>
+void Obstacle::updateAll<ObstacleType::MOVING_VERTICAL>(Obstacle* obstacles, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        Obstacle& o = obstacles[i];
+        o.timeAlive += 0.05f;
+        o.x += o.velocityX;
+        o.y += o.velocityY;
+        
+        // Bounce between bounds
+        bool bounce = o.y <= 100 || o.y >= 600;
+        o.velocityY = bounce ? -o.velocityY : o.velocityY;
+        o.active = o.active && o.x >= -o.width;
     }
 }
 
-void Obstacle::render(SDL_Renderer* renderer) {
+template <>
+void Obstacle::updateAll<ObstacleType::ROTATING>(Obstacle* obstacles, size_t count) {
+    // Rotation is visual only (see render); bounds stay axis-aligned
+    updateAll<ObstacleType::STATIC_BARRIER>(obstacles, count);
+}
+
+void Obstacle::render(RenderBackend* renderer, SpriteCache& sprites, bool shadows) {
     if (!active) return;
     
     int intX = static_cast<int>(x);
     int intY = static_cast<int>(y);
     
-    // Shadow
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 40);
-    SDL_Rect shadow = {intX + 2, intY + 2, width, height};
-    SDL_RenderFillRect(renderer, &shadow);
+    SDL_Texture* sprite = sprites.getObstacle(type, width, height, shadows);
+    if (!sprite) {
+        drawSprite(renderer, intX, intY, width, height, type, shadows);
+        return;
+    }
+    
+    SDL_Rect dest = {intX - SPRITE_ORIGIN, intY - SPRITE_ORIGIN, width + SPRITE_PADDING, height + SPRITE_PADDING};
+    if (type == ObstacleType::ROTATING) {
+        // Swing back and forth about the center, about once every two
+        // seconds; kept within 15 degrees so the hazard stays close to its
+        // collision box
+        double angle = 15.0 * std::sin(timeAlive);
+        SDL_Point center = {SPRITE_ORIGIN + width / 2, SPRITE_ORIGIN + height / 2};
+        renderer->copyEx(sprite, nullptr, &dest, angle, &center, SDL_FLIP_NONE);
+    } else {
+        renderer->copy(sprite, nullptr, &dest);
+    }
+}
+
+void Obstacle::drawSprite(RenderBackend* renderer, int intX, int intY, int width, int height, ObstacleType type,
+                          bool shadow) {
+    if (shadow) {
+        renderer->setDrawColor(0, 0, 0, 40);
+        SDL_Rect shadowRect = {intX + 2, intY + 2, width, height};
+        renderer->fillRect(&shadowRect);
+    }
     
     // Different colors and effects for different types
     switch(type) {
         case ObstacleType::STATIC_BARRIER: {
             // 3D stone block effect
-            SDL_SetRenderDrawColor(renderer, 120, 120, 120, 255);
+            renderer->setDrawColor(120, 120, 120, 255);
             SDL_Rect baseRect = {intX, intY, width, height};
-            SDL_RenderFillRect(renderer, &baseRect);
+            renderer->fillRect(&baseRect);
             
             // Highlight (top-left)
-            SDL_SetRenderDrawColor(renderer, 160, 160, 160, 255);
+            renderer->setDrawColor(160, 160, 160, 255);
             SDL_Rect highlight = {intX, intY, width - 2, 3};
-            SDL_RenderFillRect(renderer, &highlight);
+            renderer->fillRect(&highlight);
             SDL_Rect highlight2 = {intX, intY, 3, height - 2};
-            SDL_RenderFillRect(renderer, &highlight2);
+            renderer->fillRect(&highlight2);
             
             // Shadow edge (bottom-right)
-            SDL_SetRenderDrawColor(renderer, 80, 80, 80, 255);
+            renderer->setDrawColor(80, 80, 80, 255);
             SDL_Rect shadowEdge = {intX + 2, intY + height - 3, width - 2, 3};
-            SDL_RenderFillRect(renderer, &shadowEdge);
+            renderer->fillRect(&shadowEdge);
             SDL_Rect shadowEdge2 = {intX + width - 3, intY + 2, 3, height - 2};
-            SDL_RenderFillRect(renderer, &shadowEdge2);
+            renderer->fillRect(&shadowEdge2);
             break;
         }
             
         case ObstacleType::MOVING_VERTICAL: {
             // Purple energy barrier with glow
-            SDL_SetRenderDrawColor(renderer, 180, 100, 180, 255);
+            renderer->setDrawColor(180, 100, 180, 255);
             SDL_Rect energyCore = {intX, intY, width, height};
-            SDL_RenderFillRect(renderer, &energyCore);
+            renderer->fillRect(&energyCore);
             
             // Glow effect
-            SDL_SetRenderDrawColor(renderer, 220, 140, 220, 150);
+            renderer->setDrawColor(220, 140, 220, 150);
             SDL_Rect glow = {intX - 1, intY - 1, width + 2, height + 2};
-            SDL_RenderDrawRect(renderer, &glow);
+            renderer->drawRect(&glow);
             
             // Energy lines
-            SDL_SetRenderDrawColor(renderer, 255, 200, 255, 255);
+            renderer->setDrawColor(255, 200, 255, 255);
             for (int i = 0; i < height; i += 8) {
-                SDL_RenderDrawLine(renderer, intX, intY + i, intX + width, intY + i);
+                renderer->drawLine(intX, intY + i, intX + width, intY + i);
             }
             break;
         }
             
         case ObstacleType::ROTATING: {
             // Orange/brown rotating hazard
-            SDL_SetRenderDrawColor(renderer, 200, 130, 70, 255);
+            renderer->setDrawColor(200, 130, 70, 255);
             SDL_Rect rotatingBase = {intX, intY, width, height};
-            SDL_RenderFillRect(renderer, &rotatingBase);
+            renderer->fillRect(&rotatingBase);
             
             // Diagonal stripes for hazard warning
-            SDL_SetRenderDrawColor(renderer, 255, 200, 100, 255);
+            renderer->setDrawColor(255, 200, 100, 255);
             for (int i = 0; i < width + height; i += 10) {
-                SDL_RenderDrawLine(renderer, intX + i, intY, intX, intY + i);
+                renderer->drawLine(intX + i, intY, intX, intY + i);
             }
             
             // Border
-            SDL_SetRenderDrawColor(renderer, 150, 80, 40, 255);
+            renderer->setDrawColor(150, 80, 40, 255);
             SDL_Rect border = {intX, intY, width, height};
-            SDL_RenderDrawRect(renderer, &border);
+            renderer->drawRect(&border);
             break;
         }
     }
     
     // Main border for all types
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    renderer->setDrawColor(0, 0, 0, 255);
     SDL_Rect mainBorder = {intX, intY, width, height};
-    SDL_RenderDrawRect(renderer, &mainBorder);
+    renderer->drawRect(&mainBorder);
 }
 
 SDL_Rect Obstacle::getBounds() const {
@@ -0,0 +1,83 @@
+#include "Offscreen.h"
+
+OffscreenRenderer::OffscreenRenderer()
+    : surface(nullptr), renderer(nullptr), grayscale(false) {
+}
+
+OffscreenRenderer::~OffscreenRenderer() {
+    cleanup();
+}
+
+bool OffscreenRenderer::init(int logicalWidth, int logicalHeight, int downscale, bool gray) {
+    cleanup();
+    
+    if (downscale < 1) downscale = 1;
+    int width = logicalWidth / downscale;
+    int height = logicalHeight / downscale;
+    if (width < 1 || height < 1) return false;
+    
+    surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_XRGB8888);
+    if (!surface) return false;
+    
+    renderer = SDL_CreateSoftwareRenderer(surface);
+    if (!renderer) {
+        cleanup();
+        return false;
+    }
+    
+    // Rasterize straight at the reduced size
+    SDL_RenderSetScale(renderer,
+                       static_cast<float>(width) / logicalWidth,
+                       static_cast<float>(height) / logicalHeight);
+    
+    grayscale = gray;
+    if (grayscale) {
+        grayPixels.assign(static_cast<size_t>(width) * height, 0);
+    } else {
+        grayPixels.clear();
+    }
+    return true;
+}
+
+void OffscreenRenderer::cleanup() {
+    if (renderer) {
+        SDL_DestroyRenderer(renderer);
+        renderer = nullptr;
+    }
+    if (surface) {
+        SDL_FreeSurface(surface);
+        surface = nullptr;
+    }
+    grayPixels.clear();
+}
+
+const Uint8* OffscreenRenderer::getFrame(int& width, int& height, int& pitch, int& channels) {
+    if (!surface) return nullptr;
+    
+    width = surface->w;
+    height = surface->h;
+    
+    if (!grayscale) {
+        pitch = surface->pitch;
+        channels = 4;
+        return static_cast<const Uint8*>(surface->pixels);
+    }
+    
+    // Integer BT.601 luma: (77 R + 150 G + 29 B) / 256
+    const Uint8* src = static_cast<const Uint8*>(surface->pixels);
+    Uint8* dst = grayPixels.data();
+    for (int y = 0; y < height; y++) {
+        const Uint32* row = reinterpret_cast<const Uint32*>(src + y * surface->pitch);
+        for (int x = 0; x < width; x++) {
+            Uint32 p = row[x];
+            Uint32 r = (p >> 16) & 0xFF;
+            Uint32 g = (p >> 8) & 0xFF;
+            Uint32 b = p & 0xFF;
+            *dst++ = static_cast<Uint8>((77 * r + 150 * g + 29 * b) >> 8);
+        }
+    }
+    
+    pitch = width;
+    channels = 1;
+    return grayPixels.data();
+}
@@ -1,5 +1,8 @@
 #include "Particle.h"
+#include "AllocTracker.h"
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 Particle::Particle(float startX, float startY, float velX, float velY, Uint8 red, Uint8 green, Uint8 blue)
     : x(startX), y(startY), velocityX(velX), velocityY(velY), 
@@ -17,13 +20,100 @@ void Particle::update() {
     }
 }
 
-void Particle::render(SDL_Renderer* renderer) {
-    if (!active) return;
-    
+SDL_Rect Particle::getRect() const {
+    SDL_Rect rect = {static_cast<int>(x), static_cast<int>(y), size, size};
+    return rect;
+}
+
+SDL_Color Particle::getColor() const {
     // Fade out
     float alpha = 1.0f - (static_cast<float>(lifetime) / maxLifetime);
-    SDL_SetRenderDrawColor(renderer, r, g, b, static_cast<Uint8>(255 * alpha));
+    SDL_Color color = {r, g, b, static_cast<Uint8>(255 * alpha)};
+    return color;
+}
+
+Uint32 Particle::getVariant() const {
+    Uint32 bits;
+    std::memcpy(&bits, &velocityX, sizeof(bits));
+    bits ^= static_cast<Uint32>(r) << 16 | static_cast<Uint32>(g) << 8 | b;
+    return (bits * 2654435761u) >> 16;
+}
+
+ParticleBatch::ParticleBatch(size_t capacity) {
+    AllocScope scope(AllocTag::PARTICLES);
+    vertices.resize(capacity * 4);
+    indices.resize(capacity * 6);
+    rects.resize(capacity);
     
-    SDL_Rect rect = {static_cast<int>(x), static_cast<int>(y), size, size};
-    SDL_RenderFillRect(renderer, &rect);
+    for (size_t i = 0; i < capacity; i++) {
+        int base = static_cast<int>(i * 4);
+        int* quad = &indices[i * 6];
+        quad[0] = base;
+        quad[1] = base + 1;
+        quad[2] = base + 2;
+        quad[3] = base + 2;
+        quad[4] = base + 3;
+        quad[5] = base;
+    }
+}
+
+void ParticleBatch::draw(RenderBackend* renderer, const std::vector<Particle>& particles, int stride, size_t cap) {
+    // Blend only for particles; the rest of the scene draws as before
+    renderer->setDrawBlendMode(SDL_BLENDMODE_BLEND);
+    
+    size_t limit = std::min(cap, vertices.size() / 4);
+    size_t count = 0;
+    for (const Particle& particle : particles) {
+        if (count >= limit) break;
+        if (!particle.isActive() || particle.getVariant() % stride != 0) continue;
+        
+        SDL_Rect rect = particle.getRect();
+        SDL_Color color = particle.getColor();
+        float left = static_cast<float>(rect.x);
+        float top = static_cast<float>(rect.y);
+        float right = static_cast<float>(rect.x + rect.w);
+        float bottom = static_cast<float>(rect.y + rect.h);
+        
+        SDL_Vertex* quad = &vertices[count * 4];
+        quad[0] = {{left, top}, color, {0.0f, 0.0f}};
+        quad[1] = {{right, top}, color, {0.0f, 0.0f}};
+        quad[2] = {{right, bottom}, color, {0.0f, 0.0f}};
+        quad[3] = {{left, bottom}, color, {0.0f, 0.0f}};
+        count++;
+    }
+    
+    if (count > 0 && !renderer->geometry(nullptr, vertices.data(), static_cast<int>(count * 4),
+                                         indices.data(), static_cast<int>(count * 6))) {
+        drawRects(renderer, particles, stride, limit);
+    }
+    
+    renderer->setDrawBlendMode(SDL_BLENDMODE_NONE);
+}
+
+void ParticleBatch::drawRects(RenderBackend* renderer, const std::vector<Particle>& particles, int stride, size_t cap) {
+    // A burst's sparks share color and age, so runs are long
+    int count = 0;
+    size_t drawn = 0;
+    SDL_Color runColor = {0, 0, 0, 0};
+    for (const Particle& particle : particles) {
+        if (drawn >= cap) break;
+        if (!particle.isActive() || particle.getVariant() % stride != 0) continue;
+        drawn++;
+        
+        SDL_Color color = particle.getColor();
+        bool sameColor = color.r == runColor.r && color.g == runColor.g &&
+                         color.b == runColor.b && color.a == runColor.a;
+        if (count > 0 && (!sameColor || count == static_cast<int>(rects.size()))) {
+            renderer->fillRects(rects.data(), count);
+            count = 0;
+        }
+        if (count == 0) {
+            renderer->setDrawColor(color.r, color.g, color.b, color.a);
+            runColor = color;
+        }
+        rects[count++] = particle.getRect();
+    }
+    if (count > 0) {
+        renderer->fillRects(rects.data(), count);
+    }
 }
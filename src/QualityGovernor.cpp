@@ -0,0 +1,106 @@
+#include "QualityGovernor.h"
+#include <algorithm>
+
+QualityGovernor::QualityGovernor(int targetFps)
+    : fps(targetFps), budget(SDL_GetPerformanceFrequency() / targetFps), tier(QualityTier::HIGH),
+      scale(100), tierFixed(false), scaleFixed(false), samples(), sampleSum(0), next(0), filled(0),
+      calmFrames(0), upWait(MIN_UP_WAIT_SECONDS * targetFps),
+      sinceUp(MAX_UP_WAIT_SECONDS * targetFps),
+      framesAt(), scaleSum(0), lowestScale(100), stepsDown(0), stepsUp(0) {
+}
+
+void QualityGovernor::setFixedTier(QualityTier fixedTier) {
+    tier = fixedTier;
+    tierFixed = true;
+}
+
+void QualityGovernor::setFixedScale(int percent) {
+    scale = std::min(std::max(percent, MIN_SCALE), 100);
+    scaleFixed = true;
+}
+
+void QualityGovernor::restart() {
+    sampleSum = 0;
+    next = 0;
+    filled = 0;
+    calmFrames = 0;
+}
+
+bool QualityGovernor::stepDown() {
+    if (!tierFixed && tier != QualityTier::LOW) {
+        tier = static_cast<QualityTier>(static_cast<int>(tier) - 1);
+    } else if (!scaleFixed && scale > MIN_SCALE) {
+        scale = std::max(scale - SCALE_STEP, MIN_SCALE);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool QualityGovernor::stepUp() {
+    if (!scaleFixed && scale < 100) {
+        scale = std::min(scale + SCALE_STEP, 100);
+    } else if (!tierFixed && tier != QualityTier::HIGH) {
+        tier = static_cast<QualityTier>(static_cast<int>(tier) + 1);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool QualityGovernor::recordWork(Uint64 ticks) {
+    framesAt[static_cast<int>(tier)]++;
+    scaleSum += scale;
+    lowestScale = std::min(lowestScale, scale);
+    if (!isAutomatic()) return false;
+    
+    sampleSum += ticks;
+    if (filled == WINDOW) {
+        sampleSum -= samples[next];
+    } else {
+        filled++;
+    }
+    samples[next] = ticks;
+    next = (next + 1) % WINDOW;
+    sinceUp = std::min(sinceUp + 1, MAX_UP_WAIT_SECONDS * fps);
+    if (filled < WINDOW) return false;
+    
+    double load = static_cast<double>(sampleSum) / WINDOW / budget;
+    
+    if (load > STEP_DOWN) {
+        if (!stepDown()) return false;
+        
+        // Too heavy right after rising: be slower to try again
+        if (sinceUp < upWait) {
+            upWait = std::min(upWait * 2, MAX_UP_WAIT_SECONDS * fps);
+        }
+        restart();
+        stepsDown++;
+        return true;
+    }
+    
+    calmFrames = load < STEP_UP ? calmFrames + 1 : 0;
+    if (calmFrames >= upWait && stepUp()) {
+        restart();
+        sinceUp = 0;
+        stepsUp++;
+        return true;
+    }
+    return false;
+}
+
+void QualityGovernor::printReport(FILE* out) const {
+    Uint64 total = 0;
+    for (Uint64 frames : framesAt) {
+        total += frames;
+    }
+    if (total == 0) return;
+    
+    std::fprintf(out, "Quality: %s", isAutomatic() ? "automatic" : "fixed");
+    for (int i = static_cast<int>(QualityTier::COUNT) - 1; i >= 0; i--) {
+        std::fprintf(out, ", %s %.1f%%", getQualityTierName(static_cast<QualityTier>(i)),
+                     100.0 * framesAt[i] / total);
+    }
+    std::fprintf(out, "; resolution avg %.0f%%, lowest %d%%; %u steps down, %u up\n",
+                 static_cast<double>(scaleSum) / total, lowestScale, stepsDown, stepsUp);
+}
@@ -0,0 +1,244 @@
+#include "RenderBackend.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+
+void SDLRenderBackend::setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+}
+
+void SDLRenderBackend::setDrawBlendMode(SDL_BlendMode mode) {
+    SDL_SetRenderDrawBlendMode(renderer, mode);
+}
+
+void SDLRenderBackend::clear() {
+    SDL_RenderClear(renderer);
+}
+
+void SDLRenderBackend::fillRect(const SDL_Rect* rect) {
+    SDL_RenderFillRect(renderer, rect);
+}
+
+void SDLRenderBackend::fillRects(const SDL_Rect* rects, int count) {
+    SDL_RenderFillRects(renderer, rects, count);
+}
+
+void SDLRenderBackend::drawRect(const SDL_Rect* rect) {
+    SDL_RenderDrawRect(renderer, rect);
+}
+
+void SDLRenderBackend::drawLine(int x1, int y1, int x2, int y2) {
+    SDL_RenderDrawLine(renderer, x1, y1, x2, y2);
+}
+
+void SDLRenderBackend::copy(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest) {
+    SDL_RenderCopy(renderer, texture, src, dest);
+}
+
+void SDLRenderBackend::copyEx(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest,
+                              double angle, const SDL_Point* center, SDL_RendererFlip flip) {
+    SDL_RenderCopyEx(renderer, texture, src, dest, angle, center, flip);
+}
+
+bool SDLRenderBackend::geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount,
+                                const int* indices, int indexCount) {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    return SDL_RenderGeometry(renderer, texture, vertices, vertexCount, indices, indexCount) == 0;
+#else
+    (void)texture; (void)vertices; (void)vertexCount; (void)indices; (void)indexCount;
+    return false;
+#endif
+}
+
+void SDLRenderBackend::present() {
+    SDL_RenderPresent(renderer);
+}
+
+void RenderCounts::add(const RenderCounts& other) {
+    drawCalls += other.drawCalls;
+    colorChanges += other.colorChanges;
+    primitives += other.primitives;
+    pixels += other.pixels;
+}
+
+CountingRenderBackend::CountingRenderBackend(RenderBackend* inner, int targetWidth, int targetHeight)
+    : inner(inner), targetWidth(targetWidth), targetHeight(targetHeight), section(RenderSection::OTHER),
+      color(0), blendMode(SDL_BLENDMODE_NONE), stateKnown(false),
+      current(), previous(), totals(), frames(0), worstDrawCalls(0) {
+}
+
+void CountingRenderBackend::setSection(RenderSection next) {
+    section = next;
+    inner->setSection(next);
+}
+
+Uint64 CountingRenderBackend::clippedArea(const SDL_Rect* rect) const {
+    if (!rect) return static_cast<Uint64>(targetWidth) * targetHeight;
+    
+    int x1 = std::max(rect->x, 0);
+    int y1 = std::max(rect->y, 0);
+    int x2 = std::min(rect->x + rect->w, targetWidth);
+    int y2 = std::min(rect->y + rect->h, targetHeight);
+    if (x2 <= x1 || y2 <= y1) return 0;
+    return static_cast<Uint64>(x2 - x1) * (y2 - y1);
+}
+
+void CountingRenderBackend::countDraw(Uint64 primitives, Uint64 pixels) {
+    RenderCounts& c = counts();
+    c.drawCalls++;
+    c.primitives += primitives;
+    c.pixels += pixels;
+}
+
+void CountingRenderBackend::setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    Uint32 packed = (static_cast<Uint32>(r) << 24) | (static_cast<Uint32>(g) << 16) |
+                    (static_cast<Uint32>(b) << 8) | a;
+    if (!stateKnown || packed != color) {
+        counts().colorChanges++;
+    }
+    color = packed;
+    stateKnown = true;
+    inner->setDrawColor(r, g, b, a);
+}
+
+void CountingRenderBackend::setDrawBlendMode(SDL_BlendMode mode) {
+    if (!stateKnown || mode != blendMode) {
+        counts().colorChanges++;
+    }
+    blendMode = mode;
+    inner->setDrawBlendMode(mode);
+}
+
+void CountingRenderBackend::clear() {
+    countDraw(1, clippedArea(nullptr));
+    inner->clear();
+}
+
+void CountingRenderBackend::fillRect(const SDL_Rect* rect) {
+    countDraw(1, clippedArea(rect));
+    inner->fillRect(rect);
+}
+
+void CountingRenderBackend::fillRects(const SDL_Rect* rects, int count) {
+    Uint64 pixels = 0;
+    for (int i = 0; i < count; i++) {
+        pixels += clippedArea(&rects[i]);
+    }
+    countDraw(count, pixels);
+    inner->fillRects(rects, count);
+}
+
+void CountingRenderBackend::drawRect(const SDL_Rect* rect) {
+    // The outline only; clipping is approximate but close enough for lines
+    Uint64 pixels = 0;
+    if (rect && rect->w > 0 && rect->h > 0) {
+        pixels = 2ULL * (rect->w + rect->h) - 4;
+    } else if (!rect) {
+        pixels = 2ULL * (targetWidth + targetHeight) - 4;
+    }
+    countDraw(1, pixels);
+    inner->drawRect(rect);
+}
+
+void CountingRenderBackend::drawLine(int x1, int y1, int x2, int y2) {
+    int length = std::max(std::abs(x2 - x1), std::abs(y2 - y1)) + 1;
+    countDraw(1, static_cast<Uint64>(length));
+    inner->drawLine(x1, y1, x2, y2);
+}
+
+void CountingRenderBackend::copy(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest) {
+    countDraw(1, clippedArea(dest));
+    inner->copy(texture, src, dest);
+}
+
+void CountingRenderBackend::copyEx(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect* dest,
+                                   double angle, const SDL_Point* center, SDL_RendererFlip flip) {
+    // Unrotated area; rotation changes the footprint little for small angles
+    countDraw(1, clippedArea(dest));
+    inner->copyEx(texture, src, dest, angle, center, flip);
+}
+
+bool CountingRenderBackend::geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount,
+                                     const int* indices, int indexCount) {
+    // Not drawn here means the caller's fallback is what gets counted
+    if (!inner->geometry(texture, vertices, vertexCount, indices, indexCount)) return false;
+    
+    // Triangle areas, unclipped
+    double area = 0.0;
+    for (int i = 0; i + 2 < indexCount; i += 3) {
+        const SDL_FPoint& a = vertices[indices[i]].position;
+        const SDL_FPoint& b = vertices[indices[i + 1]].position;
+        const SDL_FPoint& c = vertices[indices[i + 2]].position;
+        area += std::abs((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y)) * 0.5;
+    }
+    countDraw(indexCount / 3, static_cast<Uint64>(area));
+    return true;
+}
+
+void CountingRenderBackend::present() {
+    inner->present();
+    
+    Uint64 drawCalls = 0;
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        totals[i].add(current[i]);
+        drawCalls += current[i].drawCalls;
+    }
+    std::memcpy(previous, current, sizeof(current));
+    std::memset(current, 0, sizeof(current));
+    worstDrawCalls = std::max(worstDrawCalls, drawCalls);
+    frames++;
+    section = RenderSection::OTHER;
+}
+
+RenderCounts CountingRenderBackend::getFrameTotal() const {
+    RenderCounts sum = {};
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        sum.add(previous[i]);
+    }
+    return sum;
+}
+
+void CountingRenderBackend::resetStats() {
+    std::memset(current, 0, sizeof(current));
+    std::memset(previous, 0, sizeof(previous));
+    std::memset(totals, 0, sizeof(totals));
+    frames = 0;
+    worstDrawCalls = 0;
+}
+
+const char* CountingRenderBackend::getSectionName(RenderSection s) {
+    switch (s) {
+        case RenderSection::OTHER: return "other";
+        case RenderSection::SKY: return "sky";
+        case RenderSection::TERRAIN: return "terrain";
+        case RenderSection::OBSTACLES: return "obstacles";
+        case RenderSection::ENEMIES: return "enemies";
+        case RenderSection::BULLETS: return "bullets";
+        case RenderSection::PARTICLES: return "particles";
+        case RenderSection::PLAYER: return "player";
+        case RenderSection::HUD: return "hud";
+        case RenderSection::SPRITES: return "sprites";
+        default: return "?";
+    }
+}
+
+void CountingRenderBackend::printReport(FILE* out) const {
+    if (frames == 0) return;
+    
+    double n = static_cast<double>(frames);
+    std::fprintf(out, "Render cost: %llu frames, per frame average\n", static_cast<unsigned long long>(frames));
+    std::fprintf(out, "  %-10s %10s %10s %10s %12s\n", "section", "calls", "colors", "prims", "pixels");
+    
+    RenderCounts sum = {};
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        const RenderCounts& c = totals[i];
+        sum.add(c);
+        if (c.drawCalls == 0 && c.colorChanges == 0) continue;
+        std::fprintf(out, "  %-10s %10.1f %10.1f %10.1f %12.0f\n", getSectionName(static_cast<RenderSection>(i)),
+                     c.drawCalls / n, c.colorChanges / n, c.primitives / n, c.pixels / n);
+    }
+    std::fprintf(out, "  %-10s %10.1f %10.1f %10.1f %12.0f\n", "total",
+                 sum.drawCalls / n, sum.colorChanges / n, sum.primitives / n, sum.pixels / n);
+    std::fprintf(out, "  most draw calls in a frame: %llu\n", static_cast<unsigned long long>(worstDrawCalls));
+}
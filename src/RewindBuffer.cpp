@@ -0,0 +1,237 @@
+#include "RewindBuffer.h"
+#include "World.h"
+#include <cstring>
+#include <utility>
+
+namespace {
+
+const size_t NO_SPACE = static_cast<size_t>(-1);
+
+Uint64 load64(const Uint8* p) {
+    Uint64 v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// XOR cur against prev (treated as zero beyond prevSize), a word at a time
+void xorStates(const Uint8* cur, size_t curSize, const Uint8* prev, size_t prevSize, Uint8* out) {
+    size_t common = curSize < prevSize ? curSize : prevSize;
+    size_t k = 0;
+    for (; k + 8 <= common; k += 8) {
+        Uint64 v = load64(cur + k) ^ load64(prev + k);
+        std::memcpy(out + k, &v, sizeof(v));
+    }
+    for (; k < common; k++) {
+        out[k] = cur[k] ^ prev[k];
+    }
+    std::memcpy(out + common, cur + common, curSize - common);
+}
+
+// Delta stream: a control byte with the high bit set is a run of
+// (c & 0x7F) + 1 unchanged bytes; otherwise c + 1 XOR bytes follow.
+size_t encodeDelta(const Uint8* diff, size_t size, Uint8* out) {
+    size_t i = 0;
+    size_t o = 0;
+    while (i < size) {
+        // Skip unchanged words first; most of a tick's state doesn't change
+        size_t run = 0;
+        while (run + 8 <= 128 && i + run + 8 <= size && load64(diff + i + run) == 0) {
+            run += 8;
+        }
+        while (i + run < size && run < 128 && diff[i + run] == 0) {
+            run++;
+        }
+        if (run > 0) {
+            out[o++] = static_cast<Uint8>(0x80 | (run - 1));
+            i += run;
+            continue;
+        }
+
+        // Literal until two unchanged bytes in a row; a lone unchanged byte
+        // is cheaper to carry than to split the literal
+        size_t lit = 0;
+        while (i + lit < size && lit < 128) {
+            if (diff[i + lit] == 0 && (i + lit + 1 >= size || diff[i + lit + 1] == 0)) break;
+            lit++;
+        }
+        out[o++] = static_cast<Uint8>(lit - 1);
+        for (size_t k = 0; k < lit; k++) {
+            out[o++] = diff[i + k];
+        }
+        i += lit;
+    }
+    return o;
+}
+
+void applyDelta(const Uint8* in, size_t length, Uint8* state) {
+    size_t i = 0;
+    size_t o = 0;
+    while (i < length) {
+        Uint8 c = in[i++];
+        if (c & 0x80) {
+            o += (c & 0x7F) + 1;
+        } else {
+            size_t lit = c + 1;
+            for (size_t k = 0; k < lit; k++) {
+                state[o + k] ^= in[i + k];
+            }
+            i += lit;
+            o += lit;
+        }
+    }
+}
+
+}
+
+RewindBuffer::RewindBuffer(size_t budgetBytes, int maxTicks, int keyframeInterval, size_t maxSnapshotSize)
+    : data(budgetBytes), records(maxTicks + keyframeInterval),
+      firstRecord(0), recordCount(0), keyframeInterval(keyframeInterval), sinceKeyframe(0),
+      current(maxSnapshotSize), previous(maxSnapshotSize), xored(maxSnapshotSize),
+      encoded(maxSnapshotSize + maxSnapshotSize / 128 + 16), previousSize(0) {
+}
+
+void RewindBuffer::clear() {
+    firstRecord = 0;
+    recordCount = 0;
+    sinceKeyframe = 0;
+    previousSize = 0;
+}
+
+void RewindBuffer::capture(const World& world) {
+    Uint32 tick = world.getTick();
+
+    if (recordCount > 0) {
+        Uint32 newest = recordAt(recordCount - 1).tick;
+        if (tick == newest) return;
+        if (tick != newest + 1) clear();
+    }
+
+    size_t size = world.saveSnapshot(current.data(), current.size());
+    if (size == 0) return;
+
+    // Delta against the previous tick unless a keyframe is due or the delta
+    // wouldn't save anything
+    bool stored = false;
+    if (recordCount > 0 && sinceKeyframe < keyframeInterval) {
+        xorStates(current.data(), size, previous.data(), previousSize, xored.data());
+        size_t length = encodeDelta(xored.data(), size, encoded.data());
+        if (length < size) {
+            stored = append(tick, encoded.data(), length, size, false);
+        }
+    }
+    if (!stored) {
+        append(tick, current.data(), size, size, true);
+    }
+
+    std::swap(current, previous);
+    previousSize = size;
+}
+
+bool RewindBuffer::append(Uint32 tick, const Uint8* bytes, size_t length, size_t rawSize, bool keyframe) {
+    while (recordCount >= records.size()) {
+        evictOldestGroup();
+    }
+
+    size_t offset = place(length);
+    if (offset == NO_SPACE) return false;
+
+    // Making room may have evicted this delta's keyframe
+    if (!keyframe && recordCount == 0) return false;
+
+    std::memcpy(&data[offset], bytes, length);
+
+    Record& record = recordAt(recordCount);
+    record.tick = tick;
+    record.offset = static_cast<Uint32>(offset);
+    record.length = static_cast<Uint32>(length);
+    record.rawSize = static_cast<Uint32>(rawSize);
+    record.keyframe = keyframe;
+    recordCount++;
+
+    sinceKeyframe = keyframe ? 1 : sinceKeyframe + 1;
+    return true;
+}
+
+size_t RewindBuffer::place(size_t length) {
+    if (length > data.size()) return NO_SPACE;
+
+    while (recordCount > 0) {
+        const Record& oldest = recordAt(0);
+        const Record& newest = recordAt(recordCount - 1);
+        size_t end = newest.offset + newest.length;
+
+        if (newest.offset >= oldest.offset) {
+            // Live bytes are [oldest, end): use the tail, else wrap to the front
+            if (end + length <= data.size()) return end;
+            if (length <= oldest.offset) return 0;
+        } else {
+            // Live bytes wrap: [oldest, size) + [0, end)
+            if (end + length <= oldest.offset) return end;
+        }
+
+        evictOldestGroup();
+    }
+    return 0;
+}
+
+void RewindBuffer::evictOldestGroup() {
+    // Deltas are useless without the keyframe they chain from
+    do {
+        firstRecord = (firstRecord + 1) % records.size();
+        recordCount--;
+    } while (recordCount > 0 && !recordAt(0).keyframe);
+}
+
+void RewindBuffer::decode(const Record& record, Uint8* state, size_t& stateSize) const {
+    const Uint8* in = &data[record.offset];
+
+    if (record.keyframe) {
+        std::memcpy(state, in, record.rawSize);
+    } else {
+        if (record.rawSize > stateSize) {
+            std::memset(state + stateSize, 0, record.rawSize - stateSize);
+        }
+        applyDelta(in, record.length, state);
+    }
+    stateSize = record.rawSize;
+}
+
+bool RewindBuffer::rewind(World& world, unsigned int ticks) {
+    if (recordCount == 0) return false;
+
+    size_t target = ticks >= recordCount ? 0 : recordCount - 1 - ticks;
+
+    // The oldest record is always a keyframe
+    size_t key = target;
+    while (!recordAt(key).keyframe) {
+        key--;
+    }
+
+    // Rebuild into previous so the next capture deltas against it
+    size_t size = 0;
+    for (size_t i = key; i <= target; i++) {
+        decode(recordAt(i), previous.data(), size);
+    }
+
+    if (!world.restoreSnapshot(previous.data(), size)) {
+        clear();
+        return false;
+    }
+
+    previousSize = size;
+    recordCount = target + 1;
+    sinceKeyframe = static_cast<int>(target - key + 1);
+    return true;
+}
+
+unsigned int RewindBuffer::getAvailableTicks() const {
+    return recordCount > 0 ? static_cast<unsigned int>(recordCount - 1) : 0;
+}
+
+size_t RewindBuffer::getUsedBytes() const {
+    size_t used = 0;
+    for (size_t i = 0; i < recordCount; i++) {
+        used += recordAt(i).length;
+    }
+    return used;
+}
@@ -0,0 +1,249 @@
+#include "RunLog.h"
+#include "AllocTracker.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const Uint32 RUNLOG_MAGIC = 0x4E555248;  // "HRUN"
+const Uint16 RUNLOG_VERSION = 1;
+
+struct RunLogHeader {
+    Uint32 magic;
+    Uint16 version;
+    Uint16 recordSize;
+    Uint8 reserved[8];
+};
+
+static_assert(sizeof(RunLogHeader) % alignof(RunRecord) == 0, "records must stay aligned in the mapping");
+
+bool validHeader(const RunLogHeader& header) {
+    return header.magic == RUNLOG_MAGIC &&
+           header.version == RUNLOG_VERSION &&
+           header.recordSize == sizeof(RunRecord);
+}
+
+}
+
+// --- Writer ---
+
+RunLogWriter::RunLogWriter(const std::string& path)
+    : path(path), stopping(false) {
+    pending.reserve(16);
+    worker = std::thread(&RunLogWriter::run, this);
+}
+
+RunLogWriter::~RunLogWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void RunLogWriter::append(const RunRecord& record) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(record);
+    }
+    wake.notify_one();
+}
+
+void RunLogWriter::run() {
+    AllocScope scope(AllocTag::IO);
+    std::vector<RunRecord> batch;
+    batch.reserve(16);
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return !pending.empty() || stopping; });
+        
+        if (!pending.empty()) {
+            batch.swap(pending);
+            
+            lock.unlock();
+            if (!write(batch)) {
+                std::cerr << "Warning: Could not append to run log " << path << std::endl;
+            }
+            batch.clear();
+            lock.lock();
+            continue;
+        }
+        
+        if (stopping) break;
+    }
+}
+
+bool RunLogWriter::write(const std::vector<RunRecord>& batch) {
+    // "a+" so the header can be checked; writes always go to the end
+    FILE* file = std::fopen(path.c_str(), "a+b");
+    if (!file) return false;
+    
+    bool ok = std::fseek(file, 0, SEEK_END) == 0;
+    long size = ok ? std::ftell(file) : -1;
+    ok = size >= 0;
+    
+    if (ok && size == 0) {
+        RunLogHeader header = {};
+        header.magic = RUNLOG_MAGIC;
+        header.version = RUNLOG_VERSION;
+        header.recordSize = sizeof(RunRecord);
+        ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    } else if (ok) {
+        RunLogHeader header;
+        ok = std::fseek(file, 0, SEEK_SET) == 0 &&
+             std::fread(&header, sizeof(header), 1, file) == 1 &&
+             validHeader(header);
+        
+        // Drop a record left half-written by a crash so appends stay aligned
+        long tail = (size - static_cast<long>(sizeof(header))) % static_cast<long>(sizeof(RunRecord));
+        if (ok && tail != 0) {
+            ok = std::fflush(file) == 0 && ftruncate(fileno(file), size - tail) == 0;
+        }
+    }
+    
+    if (ok) {
+        ok = std::fwrite(batch.data(), sizeof(RunRecord), batch.size(), file) == batch.size();
+    }
+    ok = std::fclose(file) == 0 && ok;
+    return ok;
+}
+
+// --- Reader ---
+
+RunLogReader::RunLogReader()
+    : mapping(nullptr), mappingSize(0), records(nullptr), count(0) {
+}
+
+RunLogReader::~RunLogReader() {
+    close();
+}
+
+bool RunLogReader::open(const std::string& path) {
+    close();
+    
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    
+    size_t size = static_cast<size_t>(info.st_size);
+    if (size == 0) {
+        ::close(fd);
+        return true;
+    }
+    if (size < sizeof(RunLogHeader)) {
+        ::close(fd);
+        return false;
+    }
+    
+    void* base = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) return false;
+    
+    RunLogHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (!validHeader(header)) {
+        munmap(base, size);
+        return false;
+    }
+    
+    // Statistics walk the whole file front to back
+    madvise(base, size, MADV_SEQUENTIAL);
+    
+    mapping = base;
+    mappingSize = size;
+    records = reinterpret_cast<const RunRecord*>(static_cast<const Uint8*>(base) + sizeof(RunLogHeader));
+    count = (size - sizeof(RunLogHeader)) / sizeof(RunRecord);
+    return true;
+}
+
+void RunLogReader::close() {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+    }
+    mappingSize = 0;
+    records = nullptr;
+    count = 0;
+}
+
+Sint64 RunLogReader::getField(const RunRecord& record, RunField field) {
+    switch (field) {
+        case RunField::SCORE:          return record.score;
+        case RunField::DISTANCE:       return record.distance;
+        case RunField::ENEMIES_KILLED: return record.enemiesKilled;
+        case RunField::TICKS:          return record.ticks;
+        case RunField::FRAME_TIME_AVG: return record.frameTimeAvgUs;
+        case RunField::FRAME_TIME_MAX: return record.frameTimeMaxUs;
+    }
+    return 0;
+}
+
+void RunLogReader::top(RunField field, size_t n, std::vector<size_t>& out) const {
+    out.clear();
+    if (n == 0) return;
+    
+    // Min-heap of the best n seen so far; the worst of them sits at the front
+    struct Entry {
+        Sint64 value;
+        size_t index;
+    };
+    auto better = [](const Entry& a, const Entry& b) {
+        return a.value > b.value || (a.value == b.value && a.index < b.index);
+    };
+    
+    std::vector<Entry> heap;
+    heap.reserve(std::min(n, count));
+    for (size_t i = 0; i < count; i++) {
+        Entry entry = {getField(records[i], field), i};
+        if (heap.size() < n) {
+            heap.push_back(entry);
+            std::push_heap(heap.begin(), heap.end(), better);
+        } else if (better(entry, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = entry;
+            std::push_heap(heap.begin(), heap.end(), better);
+        }
+    }
+    
+    std::sort_heap(heap.begin(), heap.end(), better);
+    for (const Entry& entry : heap) {
+        out.push_back(entry.index);
+    }
+}
+
+void RunLogReader::percentiles(RunField field, const double* ps, size_t n, Sint64* out,
+                               std::vector<Sint64>& scratch) const {
+    if (count == 0) {
+        std::fill(out, out + n, 0);
+        return;
+    }
+    
+    scratch.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        scratch[i] = getField(records[i], field);
+    }
+    
+    // Selection per percentile, linear time each; no full sort needed
+    for (size_t k = 0; k < n; k++) {
+        double p = std::min(100.0, std::max(0.0, ps[k]));
+        size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * count));
+        rank = rank > 0 ? rank - 1 : 0;
+        
+        std::nth_element(scratch.begin(), scratch.begin() + rank, scratch.end());
+        out[k] = scratch[rank];
+    }
+}
@@ -0,0 +1,67 @@
+#include "ScoreWriter.h"
+#include "AllocTracker.h"
+#include <cstdio>
+#include <iostream>
+
+ScoreWriter::ScoreWriter(const std::string& path)
+    : path(path), tempPath(path + ".tmp"),
+      pendingScore(0), hasPending(false), stopping(false) {
+    worker = std::thread(&ScoreWriter::run, this);
+}
+
+ScoreWriter::~ScoreWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void ScoreWriter::submit(int score) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Newer requests replace older ones that haven't been written yet
+        pendingScore = score;
+        hasPending = true;
+    }
+    wake.notify_one();
+}
+
+void ScoreWriter::run() {
+    AllocScope scope(AllocTag::IO);
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return hasPending || stopping; });
+        
+        if (hasPending) {
+            int score = pendingScore;
+            hasPending = false;
+            
+            lock.unlock();
+            if (!write(score)) {
+                std::cerr << "Warning: Could not save high score to " << path << std::endl;
+            }
+            lock.lock();
+            continue;
+        }
+        
+        // Only exit once everything submitted has been written
+        if (stopping) break;
+    }
+}
+
+bool ScoreWriter::write(int score) {
+    FILE* file = std::fopen(tempPath.c_str(), "w");
+    if (!file) return false;
+    
+    bool ok = std::fprintf(file, "%d", score) > 0;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    
+    // rename() replaces the target atomically on POSIX filesystems
+    return std::rename(tempPath.c_str(), path.c_str()) == 0;
+}
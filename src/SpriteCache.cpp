@@ -0,0 +1,183 @@
+#include "SpriteCache.h"
+#include "Helicopter.h"
+#include "Enemy.h"
+#include "AllocTracker.h"
+
+namespace {
+
+// Baking changes the render target and draw state; this puts them back
+// when it goes out of scope. Switching to a texture target resets the
+// scale and viewport, which the reduced-resolution pass in
+// Game::renderWorld relies on, so those are restored too (scale first, as
+// the viewport is given in scaled coordinates).
+class RenderStateScope {
+private:
+    RenderBackend* renderer;
+    SDL_Renderer* target;
+    SDL_Texture* previousTarget;
+    SDL_BlendMode previousBlend;
+    float previousScaleX;
+    float previousScaleY;
+    SDL_Rect previousViewport;
+    
+public:
+    explicit RenderStateScope(RenderBackend* renderer)
+        : renderer(renderer), target(renderer->getSDLRenderer()),
+          previousTarget(SDL_GetRenderTarget(target)), previousBlend(SDL_BLENDMODE_NONE),
+          previousScaleX(1.0f), previousScaleY(1.0f), previousViewport() {
+        SDL_GetRenderDrawBlendMode(target, &previousBlend);
+        SDL_RenderGetScale(target, &previousScaleX, &previousScaleY);
+        SDL_RenderGetViewport(target, &previousViewport);
+    }
+    
+    ~RenderStateScope() {
+        SDL_SetRenderTarget(target, previousTarget);
+        SDL_RenderSetScale(target, previousScaleX, previousScaleY);
+        SDL_RenderSetViewport(target, &previousViewport);
+        renderer->setDrawBlendMode(previousBlend);
+    }
+    
+    RenderStateScope(const RenderStateScope&) = delete;
+    RenderStateScope& operator=(const RenderStateScope&) = delete;
+};
+
+}
+
+SpriteCache::SpriteCache()
+    : owner(nullptr), targetsSupported(false), helicopter(), enemy(), useClock(0) {
+    obstacles.reserve(MAX_OBSTACLE_SPRITES);
+}
+
+SpriteCache::~SpriteCache() {
+    cleanup();
+}
+
+template <typename Draw>
+SDL_Texture* SpriteCache::bake(RenderBackend* renderer, int width, int height, Draw draw) {
+    SDL_Texture* texture = SDL_CreateTexture(renderer->getSDLRenderer(), SDL_PIXELFORMAT_RGBA8888,
+                                             SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!texture) return nullptr;
+    
+    if (SDL_SetRenderTarget(renderer->getSDLRenderer(), texture) != 0) {
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+    
+    // Transparent background. Primitives are written as-is, alpha included,
+    // so translucent parts (glass, rotor blur, shadow) stay translucent
+    // when the sprite is blended onto the scene; blending here instead
+    // would darken them against the empty background.
+    renderer->setDrawBlendMode(SDL_BLENDMODE_NONE);
+    renderer->setDrawColor(0, 0, 0, 0);
+    renderer->clear();
+    draw();
+    
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return texture;
+}
+
+void SpriteCache::prepare(RenderBackend* renderer) {
+    if (renderer == owner) return;
+    
+    AllocScope scope(AllocTag::SPRITES);
+    cleanup();
+    owner = renderer;
+    targetsSupported = false;
+    
+    // Nothing to bake into without an SDL renderer behind the backend
+    if (!renderer->getSDLRenderer()) return;
+    renderer->setSection(RenderSection::SPRITES);
+    
+    {
+        RenderStateScope restore(renderer);
+        for (int frame = 0; frame < 2; frame++) {
+            for (int variant = 0; variant < 2; variant++) {
+                bool on = variant != 0;
+                helicopter[frame][variant] = bake(renderer, Helicopter::SPRITE_WIDTH, Helicopter::SPRITE_HEIGHT, [&] {
+                    Helicopter::drawSprite(renderer, Helicopter::SPRITE_ORIGIN_X, Helicopter::SPRITE_ORIGIN_Y, frame, on);
+                });
+                for (int shadow = 0; shadow < 2; shadow++) {
+                    enemy[frame][variant][shadow] = bake(renderer, Enemy::SPRITE_WIDTH, Enemy::SPRITE_HEIGHT, [&] {
+                        Enemy::drawSprite(renderer, Enemy::SPRITE_ORIGIN_X, Enemy::SPRITE_ORIGIN_Y, frame, on, shadow != 0);
+                    });
+                }
+            }
+        }
+    }
+    
+    // All or nothing, so every vehicle is drawn the same way
+    for (int frame = 0; frame < 2; frame++) {
+        for (int variant = 0; variant < 2; variant++) {
+            if (!helicopter[frame][variant] || !enemy[frame][variant][0] || !enemy[frame][variant][1]) {
+                cleanup();
+                owner = renderer;
+                return;
+            }
+        }
+    }
+    targetsSupported = true;
+}
+
+SDL_Texture* SpriteCache::getObstacle(ObstacleType type, int width, int height, bool shadow) {
+    if (!targetsSupported) return nullptr;
+    
+    Uint32 key = (shadow ? 1u << 31 : 0u) |
+                 (static_cast<Uint32>(type) << 24) |
+                 ((static_cast<Uint32>(width) & 0xFFF) << 12) |
+                 (static_cast<Uint32>(height) & 0xFFF);
+    useClock++;
+    
+    for (ObstacleSprite& sprite : obstacles) {
+        if (sprite.key == key) {
+            sprite.lastUsed = useClock;
+            return sprite.texture;
+        }
+    }
+    
+    // Miss: bake it, reusing the least recently used slot when full
+    owner->setSection(RenderSection::SPRITES);
+    SDL_Texture* texture;
+    {
+        RenderStateScope restore(owner);
+        texture = bake(owner, width + Obstacle::SPRITE_PADDING, height + Obstacle::SPRITE_PADDING, [&] {
+            Obstacle::drawSprite(owner, Obstacle::SPRITE_ORIGIN, Obstacle::SPRITE_ORIGIN, width, height, type, shadow);
+        });
+    }
+    owner->setSection(RenderSection::OBSTACLES);  // Misses happen mid-obstacle pass
+    if (!texture) return nullptr;
+    
+    if (obstacles.size() < MAX_OBSTACLE_SPRITES) {
+        obstacles.push_back({key, useClock, texture});
+    } else {
+        ObstacleSprite* oldest = &obstacles[0];
+        for (ObstacleSprite& sprite : obstacles) {
+            if (sprite.lastUsed < oldest->lastUsed) oldest = &sprite;
+        }
+        SDL_DestroyTexture(oldest->texture);
+        *oldest = {key, useClock, texture};
+    }
+    return texture;
+}
+
+void SpriteCache::cleanup() {
+    for (int frame = 0; frame < 2; frame++) {
+        for (int variant = 0; variant < 2; variant++) {
+            if (helicopter[frame][variant]) {
+                SDL_DestroyTexture(helicopter[frame][variant]);
+                helicopter[frame][variant] = nullptr;
+            }
+            for (int shadow = 0; shadow < 2; shadow++) {
+                if (enemy[frame][variant][shadow]) {
+                    SDL_DestroyTexture(enemy[frame][variant][shadow]);
+                    enemy[frame][variant][shadow] = nullptr;
+                }
+            }
+        }
+    }
+    for (ObstacleSprite& sprite : obstacles) {
+        SDL_DestroyTexture(sprite.texture);
+    }
+    obstacles.clear();
+    owner = nullptr;
+    targetsSupported = false;
+}
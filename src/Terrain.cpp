@@ -1,14 +1,40 @@
 #include "Terrain.h"
 #include "CollisionDetector.h"
 #include <cmath>
-#include <cstdlib>
-#include <ctime>
+#include <algorithm>
+#include <cstring>
 
 Terrain::Terrain(int width, int height, int speed) 
-    : scrollSpeed(speed), screenWidth(width), screenHeight(height) {
+    : scrollSpeed(speed), screenWidth(width), screenHeight(height), seed(0),
+      scrolled(0), meshFirst(0), meshStart(0), meshCount(0), meshDirty(true) {
     
-    srand(time(nullptr));
-    seed = rand();
+    // Room for a full screen of points plus the scroll margins, so scrolling
+    // and restoring never reallocate
+    size_t capacity = (screenWidth + 120) / POINT_SPACING + 4;
+    points.reserve(capacity);
+    
+    // Twice the points so dropped samples are compacted away only now and
+    // then. Indices go segment by segment, all of a tier's layers each, so
+    // any prefix covers a whole number of segments.
+    static const std::vector<int> tierLayers[DETAIL_TIERS] = {
+        {0, 6},                 // Ceiling, plain ground
+        {0, 6, 4},              // ... and grass
+        {0, 1, 2, 3, 4, 5}      // Ceiling and edge; rock, dirt, grass and highlight
+    };
+    meshVertices.resize(capacity * 2 * SAMPLE_VERTICES);
+    for (int tier = 0; tier < DETAIL_TIERS; tier++) {
+        const std::vector<int>& layers = tierLayers[tier];
+        meshLayers[tier] = static_cast<int>(layers.size());
+        meshIndices[tier].reserve((capacity - 1) * layers.size() * 6);
+        for (size_t i = 0; i + 1 < capacity; i++) {
+            for (int layer : layers) {
+                int top = static_cast<int>(i * SAMPLE_VERTICES) + layer * 2;
+                int nextTop = top + SAMPLE_VERTICES;
+                int indices[6] = {top, nextTop, top + 1, top + 1, nextTop, nextTop + 1};
+                meshIndices[tier].insert(meshIndices[tier].end(), indices, indices + 6);
+            }
+        }
+    }
     
     // Initialize terrain points
     for (int i = 0; i < screenWidth + 100; i += 10) {
@@ -41,6 +67,7 @@ void Terrain::update() {
     for (auto& point : points) {
         point.x -= scrollSpeed;
     }
+    scrolled += scrollSpeed;
     
     // Remove off-screen points and add new ones
     while (!points.empty() && points[0].x < -20) {
@@ -56,23 +83,128 @@ void Terrain::update() {
     }
 }
 
-void Terrain::render(SDL_Renderer* renderer) {
+void Terrain::writeSample(size_t slot, const TerrainPoint& point) {
+    // Layers: ceiling, ceiling edge, then the ground's rock, dirt and grass
+    // bands and the grass highlight on top; last, the whole ground in rock
+    // color for the lower tiers
+    static const SDL_Color colors[MESH_LAYERS] = {
+        {60, 60, 80, 255}, {40, 40, 60, 255},
+        {70, 60, 50, 255}, {100, 80, 50, 255}, {80, 150, 60, 255}, {100, 180, 80, 255},
+        {70, 60, 50, 255}
+    };
+    float ceiling = static_cast<float>(point.ceilingY);
+    float ground = static_cast<float>(point.groundY);
+    float bottom = static_cast<float>(screenHeight);
+    float tops[MESH_LAYERS] = {0.0f, ceiling - 1, ground + 20, ground + 8, ground, ground - 1, ground};
+    float bottoms[MESH_LAYERS] = {ceiling, ceiling + 1, bottom, ground + 20, ground + 8, ground + 1, bottom};
+    
+    SDL_Vertex* v = &meshVertices[slot * SAMPLE_VERTICES];
+    for (int layer = 0; layer < MESH_LAYERS; layer++) {
+        v[layer * 2] = {{0.0f, tops[layer]}, colors[layer], {0.0f, 0.0f}};
+        v[layer * 2 + 1] = {{0.0f, bottoms[layer]}, colors[layer], {0.0f, 0.0f}};
+    }
+}
+
+void Terrain::updateMesh() {
+    size_t slots = meshVertices.size() / SAMPLE_VERTICES;
+    if (points.size() * 2 > slots) {
+        meshVertices.resize(points.size() * 2 * SAMPLE_VERTICES);
+        slots = points.size() * 2;
+        meshDirty = true;
+    }
+    
+    // Skip past points that scrolled off since the last frame
+    int first = points.empty() ? 0 : points[0].x + scrolled;
+    if (!meshDirty) {
+        int dropped = (first - meshFirst) / POINT_SPACING;
+        if (dropped < 0 || first != meshFirst + dropped * POINT_SPACING ||
+            static_cast<size_t>(dropped) > meshCount) {
+            meshDirty = true;
+        } else {
+            meshStart += dropped;
+            meshCount -= dropped;
+        }
+    }
+    if (meshDirty) {
+        meshStart = 0;
+        meshCount = 0;
+        meshDirty = false;
+    }
+    meshFirst = first;
+    
+    if (meshStart + points.size() > slots) {
+        std::memmove(&meshVertices[0], &meshVertices[meshStart * SAMPLE_VERTICES],
+                     meshCount * SAMPLE_VERTICES * sizeof(SDL_Vertex));
+        meshStart = 0;
+    }
+    
+    // Only new points need their heights and colors written
+    for (size_t i = meshCount; i < points.size(); i++) {
+        writeSample(meshStart + i, points[i]);
+    }
+    meshCount = points.size();
+    
+    for (size_t i = 0; i < meshCount; i++) {
+        float x = static_cast<float>(points[i].x);
+        SDL_Vertex* v = &meshVertices[(meshStart + i) * SAMPLE_VERTICES];
+        for (int k = 0; k < SAMPLE_VERTICES; k++) {
+            v[k].position.x = x;
+        }
+    }
+}
+
+void Terrain::render(RenderBackend* renderer, QualityTier detail) {
+    if (points.size() < 2) return;
+    
+    // Every layer of every segment in one call; per-segment rects otherwise
+    updateMesh();
+    int tier = static_cast<int>(detail);
+    size_t indexCount = std::min((meshCount - 1) * meshLayers[tier] * 6, meshIndices[tier].size());
+    if (!renderer->geometry(nullptr, &meshVertices[meshStart * SAMPLE_VERTICES],
+                            static_cast<int>(meshCount * SAMPLE_VERTICES),
+                            meshIndices[tier].data(), static_cast<int>(indexCount))) {
+        renderRects(renderer, detail);
+    }
+}
+
+void Terrain::renderRects(RenderBackend* renderer, QualityTier detail) {
     // Render ceiling with gradient effect
     for (size_t i = 0; i < points.size() - 1; i++) {
         // Dark rocky ceiling
-        SDL_SetRenderDrawColor(renderer, 60, 60, 80, 255);
+        renderer->setDrawColor(60, 60, 80, 255);
         SDL_Rect ceilingRect = {
             points[i].x,
             0,
             points[i+1].x - points[i].x + 1,
             points[i].ceilingY
         };
-        SDL_RenderFillRect(renderer, &ceilingRect);
+        renderer->fillRect(&ceilingRect);
         
         // Ceiling edge/border (darker)
-        SDL_SetRenderDrawColor(renderer, 40, 40, 60, 255);
-        SDL_RenderDrawLine(renderer, points[i].x, points[i].ceilingY, 
-                          points[i+1].x, points[i+1].ceilingY);
+        if (detail == QualityTier::HIGH) {
+            renderer->setDrawColor(40, 40, 60, 255);
+            renderer->drawLine(points[i].x, points[i].ceilingY, 
+                              points[i+1].x, points[i+1].ceilingY);
+        }
+    }
+    
+    if (detail != QualityTier::HIGH) {
+        // Plain ground, with the grass band on top at medium
+        for (size_t i = 0; i < points.size() - 1; i++) {
+            int groundY = points[i].groundY;
+            int segmentWidth = points[i+1].x - points[i].x + 1;
+            
+            renderer->setDrawColor(70, 60, 50, 255);
+            SDL_Rect groundRect = {points[i].x, groundY, segmentWidth, screenHeight - groundY};
+            renderer->fillRect(&groundRect);
+            
+            if (detail == QualityTier::MEDIUM) {
+                renderer->setDrawColor(80, 150, 60, 255);
+                SDL_Rect grassRect = {points[i].x, groundY, segmentWidth, 8};
+                renderer->fillRect(&grassRect);
+            }
+        }
+        return;
     }
     
     // Render ground with layers for depth
@@ -80,38 +212,38 @@ void Terrain::render(SDL_Renderer* renderer) {
         int groundY = points[i].groundY;
         
         // Grass layer (top)
-        SDL_SetRenderDrawColor(renderer, 80, 150, 60, 255);
+        renderer->setDrawColor(80, 150, 60, 255);
         SDL_Rect grassRect = {
             points[i].x,
             groundY,
             points[i+1].x - points[i].x + 1,
             8
         };
-        SDL_RenderFillRect(renderer, &grassRect);
+        renderer->fillRect(&grassRect);
         
         // Dirt layer (middle)
-        SDL_SetRenderDrawColor(renderer, 100, 80, 50, 255);
+        renderer->setDrawColor(100, 80, 50, 255);
         SDL_Rect dirtRect = {
             points[i].x,
             groundY + 8,
             points[i+1].x - points[i].x + 1,
             12
         };
-        SDL_RenderFillRect(renderer, &dirtRect);
+        renderer->fillRect(&dirtRect);
         
         // Rock layer (bottom)
-        SDL_SetRenderDrawColor(renderer, 70, 60, 50, 255);
+        renderer->setDrawColor(70, 60, 50, 255);
         SDL_Rect rockRect = {
             points[i].x,
             groundY + 20,
             points[i+1].x - points[i].x + 1,
             screenHeight - (groundY + 20)
         };
-        SDL_RenderFillRect(renderer, &rockRect);
+        renderer->fillRect(&rockRect);
         
         // Ground edge highlight
-        SDL_SetRenderDrawColor(renderer, 100, 180, 80, 255);
-        SDL_RenderDrawLine(renderer, points[i].x, groundY, 
+        renderer->setDrawColor(100, 180, 80, 255);
+        renderer->drawLine(points[i].x, groundY, 
                           points[i+1].x, points[i+1].groundY);
     }
 }
@@ -133,9 +265,34 @@ bool Terrain::checkCollision(const SDL_Rect& bounds) {
     return false;
 }
 
-void Terrain::reset() {
+void Terrain::getClearance(const SDL_Rect& bounds, int& groundGap, int& ceilingGap) const {
+    groundGap = screenHeight;
+    ceilingGap = screenHeight;
+    
+    // Points are sorted by x, so only visit the ones under the bounds
+    auto it = std::lower_bound(points.begin(), points.end(), bounds.x,
+        [](const TerrainPoint& point, int x) { return point.x < x; });
+    
+    for (; it != points.end() && it->x <= bounds.x + bounds.w; ++it) {
+        groundGap = std::min(groundGap, it->groundY - (bounds.y + bounds.h));
+        ceilingGap = std::min(ceilingGap, bounds.y - it->ceilingY);
+    }
+}
+
+void Terrain::restore(int savedSeed, const void* savedPoints, size_t count) {
+    // Raw bytes, possibly unaligned; capacity is reserved so this won't allocate
+    seed = savedSeed;
+    points.resize(count);
+    std::memcpy(points.data(), savedPoints, count * sizeof(TerrainPoint));
+    scrolled = 0;
+    meshDirty = true;
+}
+
+void Terrain::reset(int newSeed) {
     points.clear();
-    seed = rand();
+    seed = newSeed;
+    scrolled = 0;
+    meshDirty = true;
     
     for (int i = 0; i < screenWidth + 100; i += 10) {
         TerrainPoint point;
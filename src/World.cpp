@@ -0,0 +1,620 @@
+#include "World.h"
+#include "CollisionDetector.h"
+#include "AllocTracker.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+World::World(int screenWidth, int screenHeight)
+    : width(screenWidth), height(screenHeight),
+      player(nullptr), terrain(nullptr), enemyCapacity(MAX_ENEMIES),
+      score(0), distanceTraveled(0), enemiesKilled(0), gameOver(false),
+      deathCause(DeathCause::NONE), tick(0), events(),
+      enemySpawnTimer(0), obstacleSpawnTimer(0), enemySpawnInterval(120), obstacleSpawnInterval(90),
+      enemiesPerSpawn(1),
+      nextEntityId(0), cloudOffset1(0), cloudOffset2(0), seed(0), particleBatch(MAX_PARTICLES),
+      quality(RenderQuality::forTier(QualityTier::HIGH)) {
+    
+    AllocScope scope(AllocTag::WORLD);
+    player = new Helicopter(100, height / 2);
+    {
+        AllocScope terrainScope(AllocTag::TERRAIN);
+        terrain = new Terrain(width, height, 3);
+    }
+    
+    // Storage is charged to each entity kind for the allocation report
+    {
+        AllocScope bulletScope(AllocTag::BULLETS);
+        bullets.reserve(MAX_BULLETS);
+    }
+    {
+        // Any mix of types up to the total cap fits without reallocating
+        AllocScope enemyScope(AllocTag::ENEMIES);
+        for (auto& group : enemies) {
+            group.reserve(enemyCapacity);
+        }
+    }
+    {
+        AllocScope obstacleScope(AllocTag::OBSTACLES);
+        for (auto& group : obstacles) {
+            group.reserve(MAX_OBSTACLES);
+        }
+    }
+    {
+        AllocScope particleScope(AllocTag::PARTICLES);
+        particles.reserve(MAX_PARTICLES);
+    }
+    
+    reset(1);
+}
+
+World::~World() {
+    delete player;
+    delete terrain;
+}
+
+void World::reset(unsigned int newSeed) {
+    clearEntities();
+    
+    seed = newSeed;
+    rng.reseed(newSeed);
+    
+    // Reset player and terrain
+    player->reset(100, height / 2);
+    terrain->reset(rng.next());
+    
+    // Reset stats
+    score = 0;
+    distanceTraveled = 0;
+    enemiesKilled = 0;
+    gameOver = false;
+    deathCause = DeathCause::NONE;
+    tick = 0;
+    events = StepEvents();
+    enemySpawnTimer = 0;
+    obstacleSpawnTimer = 0;
+    nextEntityId = 0;
+    cloudOffset1 = 0;
+    cloudOffset2 = 0;
+}
+
+void World::step(bool thrust, bool shoot) {
+    events = StepEvents();
+    if (gameOver) return;
+    
+    AllocScope scope(AllocTag::WORLD);
+    tick++;
+    
+    // Update player (can't fire once the bullet pool is full)
+    {
+        AllocScope bulletScope(AllocTag::BULLETS);
+        size_t bulletsBefore = bullets.size();
+        player->update(thrust, shoot && bullets.size() < MAX_BULLETS, bullets);
+        events.shots = static_cast<int>(bullets.size() - bulletsBefore);
+    }
+    
+    // Update terrain
+    terrain->update();
+    
+    // Update bullets
+    for (auto& bullet : bullets) {
+        bullet.update();
+    }
+    
+    // Update enemies, one kernel per behavior
+    std::vector<Enemy>* e = enemies;
+    Enemy::updateAll<EnemyType::STATIONARY>(e[0].data(), e[0].size(), player->getY());
+    Enemy::updateAll<EnemyType::SINE_WAVE>(e[1].data(), e[1].size(), player->getY());
+    Enemy::updateAll<EnemyType::CHARGING>(e[2].data(), e[2].size(), player->getY());
+    Enemy::updateAll<EnemyType::SCRIPTED>(e[3].data(), e[3].size(), player->getY());
+    
+    // Update obstacles
+    std::vector<Obstacle>* o = obstacles;
+    Obstacle::updateAll<ObstacleType::STATIC_BARRIER>(o[0].data(), o[0].size());
+    Obstacle::updateAll<ObstacleType::MOVING_VERTICAL>(o[1].data(), o[1].size());
+    Obstacle::updateAll<ObstacleType::ROTATING>(o[2].data(), o[2].size());
+    
+    // Update particles
+    for (auto& particle : particles) {
+        particle.update();
+    }
+    
+    // Scroll clouds
+    cloudOffset1 = (cloudOffset1 + 1) % (width + 200);
+    cloudOffset2 = (cloudOffset2 + 1) % (width + 300);
+    
+    // Spawn enemies
+    enemySpawnTimer++;
+    if (enemySpawnInterval > 0 && enemySpawnTimer > enemySpawnInterval) {
+        for (int i = 0; i < enemiesPerSpawn; i++) {
+            spawnEnemy();
+        }
+        enemySpawnTimer = 0;
+    }
+    
+    // Spawn obstacles
+    obstacleSpawnTimer++;
+    if (obstacleSpawnInterval > 0 && obstacleSpawnTimer > obstacleSpawnInterval) {
+        spawnObstacle();
+        obstacleSpawnTimer = 0;
+    }
+    
+    // Collision detection uses the sprites' shapes where boxes overlap
+    // and, for the player, its tilt
+    const CollisionMask& playerMask = Helicopter::getCollisionMask(player->getRotation());
+    SDL_Rect playerMaskBounds = player->getMaskBounds();
+    const CollisionMask& enemyMask = Enemy::getCollisionMask();
+    
+    // Collision detection - Bullets vs Enemies
+    for (auto& bullet : bullets) {
+        if (!bullet.isActive()) continue;
+        
+        for (auto& group : enemies) {
+            for (auto& enemy : group) {
+                if (!enemy.isActive()) continue;
+                
+                if (CollisionDetector::checkCollision(enemy.getBounds(), enemyMask, bullet.getBounds())) {
+                    bullet.deactivate();
+                    enemy.takeDamage(15);
+                    
+                    if (!enemy.isActive()) {
+                        createExplosion(enemy.getBounds().x + 20, enemy.getBounds().y + 15, 20);
+                        enemiesKilled++;
+                        score += 100;
+                        events.explosions++;
+                        events.explosionX = enemy.getBounds().x + 20.0f;
+                    } else {
+                        events.hits++;
+                    }
+                    break;
+                }
+            }
+            if (!bullet.isActive()) break;
+        }
+    }
+    
+    // Collision detection - Player vs Enemies
+    for (auto& group : enemies) {
+        for (auto& enemy : group) {
+            if (!enemy.isActive()) continue;
+            
+            if (CollisionDetector::checkCollision(playerMaskBounds, playerMask, enemy.getBounds(), enemyMask)) {
+                player->takeDamage(50);
+                enemy.deactivate();
+                createExplosion(enemy.getBounds().x + 20, enemy.getBounds().y + 15, 15);
+                events.explosions++;
+                events.explosionX = enemy.getBounds().x + 20.0f;
+                
+                if (!player->getIsAlive()) {
+                    endRun(DeathCause::ENEMY);
+                }
+            }
+        }
+    }
+    
+    // Collision detection - Player vs Obstacles
+    for (auto& group : obstacles) {
+        for (auto& obstacle : group) {
+            if (!obstacle.isActive()) continue;
+            
+            if (CollisionDetector::checkCollision(playerMaskBounds, playerMask, obstacle.getBounds())) {
+                player->takeDamage(100);
+                createExplosion(player->getX() + 25, player->getY() + 15, 25);
+                endRun(DeathCause::OBSTACLE);
+            }
+        }
+    }
+    
+    // Collision detection - Player vs Terrain
+    if (terrain->checkCollision(player->getBounds())) {
+        player->takeDamage(100);
+        createExplosion(player->getX() + 25, player->getY() + 15, 25);
+        endRun(DeathCause::TERRAIN);
+    }
+    
+    // Update score
+    distanceTraveled += 0.1f;
+    score = static_cast<int>(distanceTraveled) + enemiesKilled * 100;
+    
+    // Cleanup inactive entities
+    cleanupEntities();
+}
+
+void World::setSpawnIntervals(int enemyTicks, int obstacleTicks, int perSpawn) {
+    enemySpawnInterval = std::max(enemyTicks, 0);
+    obstacleSpawnInterval = std::max(obstacleTicks, 0);
+    enemiesPerSpawn = std::max(perSpawn, 1);
+}
+
+void World::setEnemyCapacity(size_t capacity) {
+    AllocScope scope(AllocTag::ENEMIES);
+    enemyCapacity = std::min(std::max(capacity, getEnemyCount()), ENEMY_CAPACITY_LIMIT);
+    for (auto& group : enemies) {
+        group.reserve(enemyCapacity);
+    }
+}
+
+void World::render(RenderBackend* renderer) {
+    sprites.prepare(renderer);
+    renderer->setSection(RenderSection::SKY);
+    
+    // Render gradient sky (light blue at top, lighter near horizon), one
+    // line per row or coarser bands at low quality
+    for (int y = 0; y < height; y += quality.skyBand) {
+        // Gradient from deep sky blue (top) to light horizon (bottom)
+        float ratio = static_cast<float>(y) / height;
+        int r = static_cast<int>(135 + ratio * 100);  // 135 -> 235
+        int g = static_cast<int>(206 + ratio * 40);   // 206 -> 246
+        int b = static_cast<int>(235 + ratio * 20);   // 235 -> 255
+        
+        renderer->setDrawColor(r, g, b, 255);
+        if (quality.skyBand == 1) {
+            renderer->drawLine(0, y, width, y);
+        } else {
+            SDL_Rect band = {0, y, width, quality.skyBand};
+            renderer->fillRect(&band);
+        }
+    }
+    
+    // Distant clouds (slower, lighter)
+    if (quality.cloudLayers >= 2) {
+        renderer->setDrawColor(255, 255, 255, 100);
+        for (int i = 0; i < 4; i++) {
+            int x = (i * 400 - cloudOffset2 / 2) % (width + 200) - 100;
+            int y = 80 + i * 30;
+            
+            // Cloud shape (multiple ellipses)
+            for (int j = 0; j < 3; j++) {
+                SDL_Rect cloud = {x + j * 40, y, 80, 40};
+                renderer->fillRect(&cloud);
+            }
+        }
+    }
+    
+    // Closer clouds (faster, more opaque)
+    if (quality.cloudLayers >= 1) {
+        renderer->setDrawColor(255, 255, 255, 150);
+        for (int i = 0; i < 3; i++) {
+            int x = (i * 450 - cloudOffset1) % (width + 150) - 75;
+            int y = 50 + i * 40;
+            
+            // Larger cloud shape
+            for (int j = 0; j < 4; j++) {
+                SDL_Rect cloud = {x + j * 35, y, 70, 45};
+                renderer->fillRect(&cloud);
+            }
+        }
+    }
+    
+    // Render terrain
+    renderer->setSection(RenderSection::TERRAIN);
+    terrain->render(renderer, quality.terrainDetail);
+    
+    // Render obstacles
+    renderer->setSection(RenderSection::OBSTACLES);
+    for (auto& group : obstacles) {
+        for (auto& obstacle : group) {
+            obstacle.render(renderer, sprites, quality.shadows);
+        }
+    }
+    
+    // Render enemies
+    renderer->setSection(RenderSection::ENEMIES);
+    for (auto& group : enemies) {
+        for (auto& enemy : group) {
+            enemy.render(renderer, sprites, quality.shadows);
+        }
+    }
+    
+    // Render bullets
+    renderer->setSection(RenderSection::BULLETS);
+    for (auto& bullet : bullets) {
+        bullet.render(renderer);
+    }
+    
+    // Render particles
+    renderer->setSection(RenderSection::PARTICLES);
+    particleBatch.draw(renderer, particles, quality.particleStride, quality.particleCap);
+    
+    // Render player
+    renderer->setSection(RenderSection::PLAYER);
+    player->render(renderer, sprites);
+}
+
+void World::releaseRenderResources() {
+    sprites.cleanup();
+}
+
+void World::spawnEnemy() {
+    AllocScope scope(AllocTag::ENEMIES);
+    int randY = 150 + rng.next() % 400;
+    EnemyType type = static_cast<EnemyType>(rng.next() % ENEMY_TYPE_COUNT);
+    EnemyScript script = EnemyScript::SWOOP;
+    if (type == EnemyType::SCRIPTED) {
+        script = static_cast<EnemyScript>(rng.next() % ENEMY_SCRIPT_COUNT);
+    }
+    if (getEnemyCount() < enemyCapacity) {
+        enemies[static_cast<int>(type)].emplace_back(nextEntityId++, width, randY, type, script);
+    }
+}
+
+void World::spawnObstacle() {
+    AllocScope scope(AllocTag::OBSTACLES);
+    int randY = 100 + rng.next() % 500;
+    int randH = 40 + rng.next() % 100;
+    ObstacleType type = static_cast<ObstacleType>(rng.next() % OBSTACLE_TYPE_COUNT);
+    if (getObstacleCount() < MAX_OBSTACLES) {
+        obstacles[static_cast<int>(type)].emplace_back(nextEntityId++, width, randY, 30, randH, type);
+    }
+}
+
+void World::createExplosion(float x, float y, int count) {
+    AllocScope scope(AllocTag::PARTICLES);
+    for (int i = 0; i < count; i++) {
+        float velX = -3.0f + static_cast<float>(rng.next() % 60) / 10.0f;
+        float velY = -5.0f + static_cast<float>(rng.next() % 100) / 10.0f;
+        Uint8 r = 200 + rng.next() % 56;
+        Uint8 g = 100 + rng.next() % 100;
+        if (particles.size() < MAX_PARTICLES) {
+            particles.emplace_back(x, y, velX, velY, r, g, 0);
+        }
+    }
+}
+
+void World::cleanupEntities() {
+    // Remove inactive entities
+    bullets.erase(
+        std::remove_if(bullets.begin(), bullets.end(),
+            [](const Bullet& b) { return !b.isActive(); }),
+        bullets.end()
+    );
+    
+    for (auto& group : enemies) {
+        group.erase(
+            std::remove_if(group.begin(), group.end(),
+                [](const Enemy& e) { return !e.isActive(); }),
+            group.end()
+        );
+    }
+    
+    for (auto& group : obstacles) {
+        group.erase(
+            std::remove_if(group.begin(), group.end(),
+                [](const Obstacle& o) { return !o.isActive(); }),
+            group.end()
+        );
+    }
+    
+    particles.erase(
+        std::remove_if(particles.begin(), particles.end(),
+            [](const Particle& p) { return !p.isActive(); }),
+        particles.end()
+    );
+}
+
+void World::clearEntities() {
+    bullets.clear();
+    for (auto& group : enemies) {
+        group.clear();
+    }
+    for (auto& group : obstacles) {
+        group.clear();
+    }
+    particles.clear();
+}
+
+size_t World::getEnemyCount() const {
+    size_t count = 0;
+    for (const auto& group : enemies) {
+        count += group.size();
+    }
+    return count;
+}
+
+size_t World::getObstacleCount() const {
+    size_t count = 0;
+    for (const auto& group : obstacles) {
+        count += group.size();
+    }
+    return count;
+}
+
+void World::endRun(DeathCause cause) {
+    // Several collisions can land on the same tick; the first one counts
+    if (!gameOver) {
+        deathCause = cause;
+        events.crashed = true;
+    }
+    gameOver = true;
+}
+
+namespace {
+
+const Uint32 SNAPSHOT_MAGIC = 0x33534857;  // "WHS3", scripted enemies and entity ids
+
+static_assert(std::is_trivially_copyable<Helicopter>::value, "snapshots copy Helicopter as bytes");
+static_assert(std::is_trivially_copyable<Bullet>::value, "snapshots copy Bullet as bytes");
+static_assert(std::is_trivially_copyable<Enemy>::value, "snapshots copy Enemy as bytes");
+static_assert(std::is_trivially_copyable<Obstacle>::value, "snapshots copy Obstacle as bytes");
+static_assert(std::is_trivially_copyable<Particle>::value, "snapshots copy Particle as bytes");
+
+// Fixed-size part of a snapshot; entity and terrain arrays follow it
+struct SnapshotHeader {
+    Uint32 magic;
+    Uint32 size;
+    Sint32 width, height;
+    Uint32 seed;
+    Uint32 rngState;
+    Uint32 tick;
+    Sint32 score;
+    float distanceTraveled;
+    Sint32 enemiesKilled;
+    Sint32 enemySpawnTimer;
+    Sint32 obstacleSpawnTimer;
+    Uint32 nextEntityId;
+    Sint32 cloudOffset1;
+    Sint32 cloudOffset2;
+    Sint32 terrainSeed;
+    Uint8 gameOver;
+    Uint8 deathCause;
+    Uint8 padding[2];
+    Uint16 bulletCount;
+    Uint16 enemyCounts[ENEMY_TYPE_COUNT];
+    Uint16 obstacleCounts[OBSTACLE_TYPE_COUNT];
+    Uint16 particleCount;
+    Uint16 terrainPointCount;
+    Uint16 reserved;
+};
+
+template <typename T>
+void writeArray(Uint8*& out, const T* items, size_t count) {
+    std::memcpy(out, items, count * sizeof(T));
+    out += count * sizeof(T);
+}
+
+// Copies through aligned storage so the buffer itself needs no alignment;
+// the vector's capacity is reserved, so this does not allocate
+template <typename T>
+void readArray(const Uint8*& in, std::vector<T>& items, size_t count) {
+    items.clear();
+    for (size_t i = 0; i < count; i++) {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type raw;
+        std::memcpy(&raw, in, sizeof(T));
+        items.push_back(*reinterpret_cast<const T*>(&raw));
+        in += sizeof(T);
+    }
+}
+
+}
+
+size_t World::getMaxSnapshotSize() const {
+    return sizeof(SnapshotHeader)
+         + sizeof(Helicopter)
+         + MAX_BULLETS * sizeof(Bullet)
+         + enemyCapacity * sizeof(Enemy)
+         + MAX_OBSTACLES * sizeof(Obstacle)
+         + MAX_PARTICLES * sizeof(Particle)
+         + terrain->getPointCapacity() * sizeof(Terrain::TerrainPoint);
+}
+
+size_t World::saveSnapshot(void* buffer, size_t capacity) const {
+    const auto& points = terrain->getPoints();
+    
+    size_t size = sizeof(SnapshotHeader)
+                + sizeof(Helicopter)
+                + bullets.size() * sizeof(Bullet)
+                + getEnemyCount() * sizeof(Enemy)
+                + getObstacleCount() * sizeof(Obstacle)
+                + particles.size() * sizeof(Particle)
+                + points.size() * sizeof(Terrain::TerrainPoint);
+    if (!buffer || capacity < size) return 0;
+    
+    SnapshotHeader header = {};
+    header.magic = SNAPSHOT_MAGIC;
+    header.size = static_cast<Uint32>(size);
+    header.width = width;
+    header.height = height;
+    header.seed = seed;
+    header.rngState = rng.getState();
+    header.tick = tick;
+    header.score = score;
+    header.distanceTraveled = distanceTraveled;
+    header.enemiesKilled = enemiesKilled;
+    header.enemySpawnTimer = enemySpawnTimer;
+    header.obstacleSpawnTimer = obstacleSpawnTimer;
+    header.nextEntityId = nextEntityId;
+    header.cloudOffset1 = cloudOffset1;
+    header.cloudOffset2 = cloudOffset2;
+    header.terrainSeed = terrain->getSeed();
+    header.gameOver = gameOver ? 1 : 0;
+    header.deathCause = static_cast<Uint8>(deathCause);
+    header.bulletCount = static_cast<Uint16>(bullets.size());
+    for (int i = 0; i < ENEMY_TYPE_COUNT; i++) {
+        header.enemyCounts[i] = static_cast<Uint16>(enemies[i].size());
+    }
+    for (int i = 0; i < OBSTACLE_TYPE_COUNT; i++) {
+        header.obstacleCounts[i] = static_cast<Uint16>(obstacles[i].size());
+    }
+    header.particleCount = static_cast<Uint16>(particles.size());
+    header.terrainPointCount = static_cast<Uint16>(points.size());
+    
+    Uint8* out = static_cast<Uint8*>(buffer);
+    writeArray(out, &header, 1);
+    writeArray(out, player, 1);
+    writeArray(out, bullets.data(), bullets.size());
+    for (const auto& group : enemies) {
+        writeArray(out, group.data(), group.size());
+    }
+    for (const auto& group : obstacles) {
+        writeArray(out, group.data(), group.size());
+    }
+    writeArray(out, particles.data(), particles.size());
+    writeArray(out, points.data(), points.size());
+    
+    return size;
+}
+
+bool World::restoreSnapshot(const void* buffer, size_t size) {
+    if (!buffer || size < sizeof(SnapshotHeader)) return false;
+    
+    SnapshotHeader header;
+    std::memcpy(&header, buffer, sizeof(header));
+    
+    if (header.magic != SNAPSHOT_MAGIC || header.size != size ||
+        header.width != width || header.height != height) {
+        return false;
+    }
+    size_t enemyCount = 0;
+    size_t obstacleCount = 0;
+    for (int i = 0; i < ENEMY_TYPE_COUNT; i++) {
+        enemyCount += header.enemyCounts[i];
+    }
+    for (int i = 0; i < OBSTACLE_TYPE_COUNT; i++) {
+        obstacleCount += header.obstacleCounts[i];
+    }
+    if (header.bulletCount > MAX_BULLETS || enemyCount > enemyCapacity ||
+        obstacleCount > MAX_OBSTACLES || header.particleCount > MAX_PARTICLES ||
+        header.terrainPointCount > terrain->getPointCapacity()) {
+        return false;
+    }
+    
+    size_t expected = sizeof(SnapshotHeader)
+                    + sizeof(Helicopter)
+                    + header.bulletCount * sizeof(Bullet)
+                    + enemyCount * sizeof(Enemy)
+                    + obstacleCount * sizeof(Obstacle)
+                    + header.particleCount * sizeof(Particle)
+                    + header.terrainPointCount * sizeof(Terrain::TerrainPoint);
+    if (expected != size) return false;
+    
+    seed = header.seed;
+    rng.setState(header.rngState);
+    tick = header.tick;
+    events = StepEvents();
+    score = header.score;
+    distanceTraveled = header.distanceTraveled;
+    enemiesKilled = header.enemiesKilled;
+    enemySpawnTimer = header.enemySpawnTimer;
+    obstacleSpawnTimer = header.obstacleSpawnTimer;
+    nextEntityId = header.nextEntityId;
+    cloudOffset1 = header.cloudOffset1;
+    cloudOffset2 = header.cloudOffset2;
+    gameOver = header.gameOver != 0;
+    deathCause = static_cast<DeathCause>(header.deathCause);
+    
+    const Uint8* in = static_cast<const Uint8*>(buffer) + sizeof(SnapshotHeader);
+    std::memcpy(static_cast<void*>(player), in, sizeof(Helicopter));
+    in += sizeof(Helicopter);
+    
+    readArray(in, bullets, header.bulletCount);
+    for (int i = 0; i < ENEMY_TYPE_COUNT; i++) {
+        readArray(in, enemies[i], header.enemyCounts[i]);
+    }
+    for (int i = 0; i < OBSTACLE_TYPE_COUNT; i++) {
+        readArray(in, obstacles[i], header.obstacleCounts[i]);
+    }
+    readArray(in, particles, header.particleCount);
+    terrain->restore(header.terrainSeed, in, header.terrainPointCount);
+    
+    return true;
+}
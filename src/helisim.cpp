@@ -0,0 +1,172 @@
+#include "helisim.h"
+#include "World.h"
+#include "Offscreen.h"
+#include <new>
+
+// The opaque handle wraps the World plus an optional offscreen renderer for
+// pixel observations. The renderer is declared first so it outlives the
+// textures the world creates on it.
+struct helisim_world {
+    OffscreenRenderer offscreen;
+    SDLRenderBackend backend;
+    World world;
+    bool renderReady;
+    
+    helisim_world() : backend(nullptr), world(1280, 720), renderReady(false) {}
+};
+
+namespace {
+
+template <typename T>
+void fillEntity(helisim_entity& out, const T& entity) {
+    SDL_Rect bounds = entity.getBounds();
+    out.x = static_cast<float>(bounds.x);
+    out.y = static_cast<float>(bounds.y);
+    out.width = bounds.w;
+    out.height = bounds.h;
+    out.type = static_cast<int32_t>(entity.getType());
+    out.id = entity.getId();
+}
+
+// Fill up to `limit` entries from per-type arrays, oldest first. Each array
+// is in spawn order and ids rise with it, so this is a merge on id; x says
+// nothing about age once enemies move at different speeds.
+template <typename T, int Groups>
+int32_t mergeById(const std::vector<T>* (&groups)[Groups], helisim_entity* out, int32_t limit) {
+    size_t next[Groups] = {};
+    int32_t n = 0;
+    while (n < limit) {
+        int best = -1;
+        for (int g = 0; g < Groups; g++) {
+            if (next[g] == groups[g]->size()) continue;
+            if (best < 0 || (*groups[g])[next[g]].getId() < (*groups[best])[next[best]].getId()) {
+                best = g;
+            }
+        }
+        if (best < 0) break;
+        
+        fillEntity(out[n++], (*groups[best])[next[best]++]);
+    }
+    return n;
+}
+
+}
+
+extern "C" {
+
+helisim_world* helisim_create(void) {
+    return new (std::nothrow) helisim_world();
+}
+
+void helisim_destroy(helisim_world* world) {
+    delete world;
+}
+
+void helisim_reset(helisim_world* world, uint32_t seed) {
+    world->world.reset(seed);
+}
+
+int32_t helisim_step(helisim_world* world, int32_t ticks, uint32_t action) {
+    World& w = world->world;
+    bool thrust = (action & HELISIM_ACTION_THRUST) != 0;
+    bool shoot = (action & HELISIM_ACTION_SHOOT) != 0;
+    
+    int32_t done = 0;
+    while (done < ticks && !w.isGameOver()) {
+        w.step(thrust, shoot);
+        done++;
+    }
+    return done;
+}
+
+void helisim_observe(const helisim_world* world, helisim_observation* out) {
+    const World& w = world->world;
+    const Helicopter& player = w.getPlayer();
+    
+    out->player.x = player.getX();
+    out->player.y = player.getY();
+    out->player.velocity_y = player.getVelocityY();
+    out->player.rotation = player.getRotation();
+    out->player.health = player.getHealth();
+    out->player.alive = player.getIsAlive() ? 1 : 0;
+    
+    int groundGap, ceilingGap;
+    w.getTerrain().getClearance(player.getBounds(), groundGap, ceilingGap);
+    out->ground_clearance = groundGap;
+    out->ceiling_clearance = ceilingGap;
+    
+    out->score = w.getScore();
+    out->enemies_killed = w.getEnemiesKilled();
+    out->distance = w.getDistance();
+    out->tick = w.getTick();
+    out->done = w.isGameOver() ? 1 : 0;
+    
+    const std::vector<Enemy>* enemyGroups[ENEMY_TYPE_COUNT];
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        enemyGroups[t] = &w.getEnemies(static_cast<EnemyType>(t));
+    }
+    out->num_enemies = mergeById(enemyGroups, out->enemies, HELISIM_MAX_ENEMIES);
+    out->total_enemies = static_cast<int32_t>(w.getEnemyCount());
+    
+    const std::vector<Obstacle>* obstacleGroups[OBSTACLE_TYPE_COUNT];
+    for (int t = 0; t < OBSTACLE_TYPE_COUNT; t++) {
+        obstacleGroups[t] = &w.getObstacles(static_cast<ObstacleType>(t));
+    }
+    out->num_obstacles = mergeById(obstacleGroups, out->obstacles, HELISIM_MAX_OBSTACLES);
+    out->total_obstacles = static_cast<int32_t>(w.getObstacleCount());
+}
+
+int32_t helisim_set_spawning(helisim_world* world, int32_t enemy_interval, int32_t obstacle_interval,
+                             int32_t enemies_per_spawn, int32_t enemy_capacity) {
+    if (enemy_interval < 0 || obstacle_interval < 0 || enemies_per_spawn < 1 || enemy_capacity < 1 ||
+        static_cast<size_t>(enemy_capacity) > World::ENEMY_CAPACITY_LIMIT) {
+        return -1;
+    }
+    
+    // A failed reservation must not unwind into C callers
+    try {
+        world->world.setEnemyCapacity(static_cast<size_t>(enemy_capacity));
+    } catch (const std::bad_alloc&) {
+        return -1;
+    }
+    world->world.setSpawnIntervals(enemy_interval, obstacle_interval, enemies_per_spawn);
+    return 0;
+}
+
+uint32_t helisim_snapshot_max_size(const helisim_world* world) {
+    return static_cast<uint32_t>(world->world.getMaxSnapshotSize());
+}
+
+uint32_t helisim_snapshot(const helisim_world* world, void* buffer, uint32_t size) {
+    return static_cast<uint32_t>(world->world.saveSnapshot(buffer, size));
+}
+
+int32_t helisim_restore(helisim_world* world, const void* buffer, uint32_t size) {
+    return world->world.restoreSnapshot(buffer, size) ? 0 : -1;
+}
+
+int32_t helisim_render_init(helisim_world* world, int32_t downscale, int32_t grayscale) {
+    if (downscale < 1 || downscale > 16) return -1;
+    
+    world->world.releaseRenderResources();
+    world->renderReady = world->offscreen.init(world->world.getWidth(), world->world.getHeight(),
+                                               downscale, grayscale != 0);
+    world->backend = SDLRenderBackend(world->offscreen.getRenderer());
+    return world->renderReady ? 0 : -1;
+}
+
+int32_t helisim_render(helisim_world* world, helisim_frame* out) {
+    if (!world->renderReady) return -1;
+    
+    world->world.render(&world->backend);
+    
+    int width, height, pitch, channels;
+    out->pixels = world->offscreen.getFrame(width, height, pitch, channels);
+    out->width = width;
+    out->height = height;
+    out->pitch = pitch;
+    out->channels = channels;
+    return 0;
+}
+
+}
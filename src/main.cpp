@@ -1,9 +1,69 @@
 #include "Game.h"
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
 
 int main(int argc, char* argv[]) {
     Game game;
     
+    // --frame-stats reports frame pacing and quality steps at exit. --latency
+    // reports input-to-present latency at exit; --latency-frames also prints
+    // it for every frame that carried input. --render-stats reports draw calls
+    // per subsystem. --alloc-stats reports heap allocations per frame and
+    // subsystem; --alloc-check also aborts on any allocation in the game
+    // update once play has warmed up. --capture FILE records gameplay (Y4M for
+    // .y4m, raw RGB otherwise), dropping frames if the disk falls behind
+    // unless --capture-block is also given. --metrics publishes live metrics
+    // to shared memory for metrics_export, under METRICS_DEFAULT_NAME or the
+    // name given with --metrics-name. --quality low|medium|high holds the
+    // effects at one tier and --render-scale PERCENT (50-100) the world's
+    // render resolution; by default both follow frame times. --no-audio plays
+    // without sound; --audio-stats reports voices used and trigger latency at
+    // exit.
+    std::string capturePath;
+    bool captureBlock = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--frame-stats") == 0) {
+            game.enableFrameStats();
+        } else if (std::strcmp(argv[i], "--latency") == 0) {
+            game.enableLatencyReport(false);
+        } else if (std::strcmp(argv[i], "--latency-frames") == 0) {
+            game.enableLatencyReport(true);
+        } else if (std::strcmp(argv[i], "--render-stats") == 0) {
+            game.enableRenderStats();
+        } else if (std::strcmp(argv[i], "--alloc-stats") == 0) {
+            game.enableAllocReport(false);
+        } else if (std::strcmp(argv[i], "--alloc-check") == 0) {
+            game.enableAllocReport(true);
+        } else if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            capturePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--capture-block") == 0) {
+            captureBlock = true;
+        } else if (std::strcmp(argv[i], "--metrics") == 0) {
+            game.enableMetrics(METRICS_DEFAULT_NAME);
+        } else if (std::strcmp(argv[i], "--metrics-name") == 0 && i + 1 < argc) {
+            game.enableMetrics(argv[++i]);
+        } else if (std::strcmp(argv[i], "--quality") == 0 && i + 1 < argc) {
+            QualityTier tier;
+            if (parseQualityTier(argv[++i], tier)) {
+                game.setFixedQuality(tier);
+            } else {
+                std::cerr << "Unknown quality " << argv[i] << "; expected low, medium or high" << std::endl;
+            }
+        } else if (std::strcmp(argv[i], "--render-scale") == 0 && i + 1 < argc) {
+            game.setFixedRenderScale(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--no-audio") == 0) {
+            game.disableAudio();
+        } else if (std::strcmp(argv[i], "--audio-stats") == 0) {
+            game.enableAudioReport();
+        }
+    }
+    
+    if (!capturePath.empty()) {
+        game.enableCapture(capturePath, captureBlock ? CapturePolicy::BLOCK : CapturePolicy::DROP);
+    }
+    
     if (!game.init()) {
         std::cerr << "Failed to initialize game!" << std::endl;
         return 1;
@@ -14,6 +74,7 @@ int main(int argc, char* argv[]) {
     std::cout << "  UP ARROW - Thrust (hold to rise, release to fall)" << std::endl;
     std::cout << "  SPACE/X - Shoot" << std::endl;
     std::cout << "  P/ESC - Pause" << std::endl;
+    std::cout << "  LEFT ARROW - Rewind (while paused or after a crash)" << std::endl;
     std::cout << "  ESC - Quit (from menu)" << std::endl;
     std::cout << std::endl;
     std::cout << "Objective: Avoid obstacles and terrain, shoot enemies!" << std::endl;
@@ -0,0 +1,106 @@
+/*
+ * Headless run of the audio engine on SDL's dummy audio driver.
+ *
+ *   make audiocheck && ./audio_check [-s seconds] [--device]
+ *
+ * Drives the engine the way the game does, at 60 frames a second: the rotor
+ * loop with thrust toggling, gunfire every 8 frames, a hit now and then and
+ * every 2 seconds a chain of 20 explosions on a single frame. Then crashes
+ * and restarts within the rotor's fade-out, and prints the engine's report
+ * and how long the game thread spent in the trigger calls. Exits 1 if the
+ * rotor stayed silent after the restart. Needs no sound card; --device uses
+ * the default driver instead, to listen to the result.
+ */
+#include "AudioEngine.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char* argv[]) {
+    int seconds = 10;
+    bool device = false;
+    
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seconds = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--device") == 0) {
+            device = true;
+        } else {
+            std::fprintf(stderr, "usage: %s [-s seconds] [--device]\n", argv[0]);
+            return 2;
+        }
+    }
+    
+    if (!device) {
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    }
+    if (SDL_Init(0) < 0) {
+        std::fprintf(stderr, "Could not initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    
+    AudioEngine audio;
+    if (!audio.init()) {
+        std::fprintf(stderr, "Could not open audio: %s\n", Mix_GetError());
+        SDL_Quit();
+        return 1;
+    }
+    
+    const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+    Uint64 callTicks = 0;
+    Uint64 worstCall = 0;
+    long calls = 0;
+    
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 period = SDL_GetPerformanceFrequency() / 60;
+    for (long frame = 0; frame < seconds * 60L; frame++) {
+        Uint64 before = SDL_GetPerformanceCounter();
+        
+        audio.setRotor(true, frame % 90 < 45);
+        if (frame % 8 == 0) {
+            audio.play(Sound::GUNFIRE, 0.5f, -0.4f);
+        }
+        if (frame % 25 == 0) {
+            audio.play(Sound::HIT, 0.7f, 0.2f);
+        }
+        if (frame % 120 == 60) {
+            for (int i = 0; i < 20; i++) {
+                audio.play(Sound::EXPLOSION, 1.0f, -1.0f + i * 0.1f);
+            }
+        }
+        
+        Uint64 elapsed = SDL_GetPerformanceCounter() - before;
+        callTicks += elapsed;
+        worstCall = std::max(worstCall, elapsed);
+        calls++;
+        
+        // Hold to the frame schedule
+        Uint64 deadline = start + (frame + 1) * period;
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (deadline > now) {
+            SDL_Delay(static_cast<Uint32>((deadline - now) * 1000 / SDL_GetPerformanceFrequency()));
+        }
+    }
+    
+    // A quick restart after a crash starts the rotor while its fade-out is
+    // still running; it has to come back rather than fade to silence
+    audio.play(Sound::CRASH);
+    audio.setRotor(false, false);
+    SDL_Delay(50);
+    audio.setRotor(true, false);
+    SDL_Delay(300);
+    bool rotorRestarted = Mix_Playing(0) != 0;
+    audio.setRotor(false, false);
+    SDL_Delay(200);
+    
+    audio.shutdown();
+    std::printf("%d s at 60 frames/s, %s driver\n", seconds, device ? "default" : "dummy");
+    audio.printReport(stdout);
+    std::printf("  game thread per frame avg %.2f us, worst %.2f us\n",
+                callTicks * 1e6 / frequency / std::max(calls, 1L), worstCall * 1e6 / frequency);
+    std::printf("  rotor restarted during fade-out: %s\n", rotorRestarted ? "playing" : "SILENT");
+    
+    SDL_Quit();
+    return rotorRestarted ? 0 : 1;
+}
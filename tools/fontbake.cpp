@@ -0,0 +1,197 @@
+/*
+ * Build step: rasterizes the printable ASCII glyphs of a TrueType font at
+ * the sizes the game uses and writes them out as a C++ header holding one
+ * 8-bit coverage atlas plus per-glyph metrics.
+ *
+ *   fontbake <font.ttf> <output.h>
+ *
+ * Run by the Makefile; the output is compiled into BitmapFont.cpp so the
+ * game needs no font files or FreeType at runtime.
+ */
+#include "BitmapFont.h"
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const int SIZES[] = {72, 48, 24};
+const int FACES = sizeof(SIZES) / sizeof(SIZES[0]);
+const int ATLAS_WIDTH = 1024;
+const int PADDING = 1;  // Keeps filtering from bleeding between glyphs
+
+struct Bitmap {
+    int face;
+    int glyph;
+    int w, h;
+    std::vector<Uint8> alpha;
+};
+
+// Rasterize one glyph and crop it to its inked pixels
+bool bakeGlyph(TTF_Font* font, Uint16 ch, Bitmap& out, BakedGlyph& glyph) {
+    int minX, maxX, minY, maxY, advance;
+    if (TTF_GlyphMetrics(font, ch, &minX, &maxX, &minY, &maxY, &advance) != 0) return false;
+    glyph.advance = static_cast<Sint16>(advance);
+    
+    // Rendered as a one-character string: unlike TTF_RenderGlyph_*, text
+    // rendering gives a line-height surface with bearings applied on every
+    // SDL_ttf version, and matches how whole strings used to be drawn
+    SDL_Color white = {255, 255, 255, 255};
+    char text[2] = {static_cast<char>(ch), '\0'};
+    SDL_Surface* rendered = TTF_RenderText_Blended(font, text, white);
+    if (!rendered) {
+        // Blank glyphs such as space render nothing
+        out.w = out.h = 0;
+        return true;
+    }
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(rendered);
+    if (!surface) return false;
+    
+    // The surface origin is the pen position at the top of the line
+    SDL_LockSurface(surface);
+    const Uint8* base = static_cast<const Uint8*>(surface->pixels);
+    int left = surface->w, top = surface->h, right = -1, bottom = -1;
+    for (int y = 0; y < surface->h; y++) {
+        const Uint32* row = reinterpret_cast<const Uint32*>(base + y * surface->pitch);
+        for (int x = 0; x < surface->w; x++) {
+            if (row[x] >> 24) {
+                left = std::min(left, x);
+                right = std::max(right, x);
+                top = std::min(top, y);
+                bottom = std::max(bottom, y);
+            }
+        }
+    }
+    
+    if (right < 0) {
+        out.w = out.h = 0;
+    } else {
+        out.w = right - left + 1;
+        out.h = bottom - top + 1;
+        out.alpha.resize(static_cast<size_t>(out.w) * out.h);
+        for (int y = 0; y < out.h; y++) {
+            const Uint32* row = reinterpret_cast<const Uint32*>(base + (top + y) * surface->pitch);
+            for (int x = 0; x < out.w; x++) {
+                out.alpha[y * out.w + x] = static_cast<Uint8>(row[left + x] >> 24);
+            }
+        }
+        glyph.offsetX = static_cast<Sint16>(left);
+        glyph.offsetY = static_cast<Sint16>(top);
+    }
+    
+    SDL_UnlockSurface(surface);
+    SDL_FreeSurface(surface);
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s <font.ttf> <output.h>\n", argv[0]);
+        return 1;
+    }
+    if (TTF_Init() < 0) {
+        std::fprintf(stderr, "fontbake: TTF_Init failed: %s\n", TTF_GetError());
+        return 1;
+    }
+    
+    BakedGlyph glyphs[FACES][BitmapFont::GLYPH_COUNT] = {};
+    int heights[FACES];
+    std::vector<Bitmap> bitmaps;
+    
+    for (int f = 0; f < FACES; f++) {
+        TTF_Font* font = TTF_OpenFont(argv[1], SIZES[f]);
+        if (!font) {
+            std::fprintf(stderr, "fontbake: could not open %s: %s\n", argv[1], TTF_GetError());
+            return 1;
+        }
+        heights[f] = TTF_FontHeight(font);
+        
+        for (int g = 0; g < BitmapFont::GLYPH_COUNT; g++) {
+            Bitmap bitmap;
+            bitmap.face = f;
+            bitmap.glyph = g;
+            Uint16 ch = static_cast<Uint16>(BitmapFont::FIRST_CHAR + g);
+            if (!bakeGlyph(font, ch, bitmap, glyphs[f][g])) {
+                std::fprintf(stderr, "fontbake: could not render '%c'\n", ch);
+                return 1;
+            }
+            if (bitmap.w > 0) bitmaps.push_back(std::move(bitmap));
+        }
+        TTF_CloseFont(font);
+    }
+    TTF_Quit();
+    
+    // Shelf packing, tallest first
+    std::sort(bitmaps.begin(), bitmaps.end(),
+              [](const Bitmap& a, const Bitmap& b) { return a.h > b.h; });
+    
+    int penX = 0, penY = 0, shelfHeight = 0;
+    for (Bitmap& bitmap : bitmaps) {
+        if (penX + bitmap.w > ATLAS_WIDTH) {
+            penX = 0;
+            penY += shelfHeight + PADDING;
+            shelfHeight = 0;
+        }
+        BakedGlyph& glyph = glyphs[bitmap.face][bitmap.glyph];
+        glyph.x = static_cast<Sint16>(penX);
+        glyph.y = static_cast<Sint16>(penY);
+        glyph.w = static_cast<Sint16>(bitmap.w);
+        glyph.h = static_cast<Sint16>(bitmap.h);
+        penX += bitmap.w + PADDING;
+        shelfHeight = std::max(shelfHeight, bitmap.h);
+    }
+    int atlasHeight = std::max(1, penY + shelfHeight);
+    
+    std::vector<Uint8> atlas(static_cast<size_t>(ATLAS_WIDTH) * atlasHeight, 0);
+    for (const Bitmap& bitmap : bitmaps) {
+        const BakedGlyph& glyph = glyphs[bitmap.face][bitmap.glyph];
+        for (int y = 0; y < bitmap.h; y++) {
+            std::copy_n(&bitmap.alpha[y * bitmap.w], bitmap.w,
+                        &atlas[(glyph.y + y) * ATLAS_WIDTH + glyph.x]);
+        }
+    }
+    
+    // Emit the header
+    FILE* out = std::fopen(argv[2], "w");
+    if (!out) {
+        std::fprintf(stderr, "fontbake: could not write %s\n", argv[2]);
+        return 1;
+    }
+    
+    std::fprintf(out, "// Generated by tools/fontbake from %s. Do not edit.\n", argv[1]);
+    std::fprintf(out, "constexpr int FONT_ATLAS_FACES = %d;\n", FACES);
+    std::fprintf(out, "constexpr int FONT_ATLAS_WIDTH = %d;\n", ATLAS_WIDTH);
+    std::fprintf(out, "constexpr int FONT_ATLAS_HEIGHT = %d;\n", atlasHeight);
+    std::fprintf(out, "const int FONT_ATLAS_SIZES[] = {%d, %d, %d};\n", SIZES[0], SIZES[1], SIZES[2]);
+    std::fprintf(out, "const int FONT_ATLAS_HEIGHTS[] = {%d, %d, %d};\n", heights[0], heights[1], heights[2]);
+    
+    std::fprintf(out, "const BakedGlyph FONT_ATLAS_GLYPHS[%d][%d] = {\n", FACES, BitmapFont::GLYPH_COUNT);
+    for (int f = 0; f < FACES; f++) {
+        std::fprintf(out, "{\n");
+        for (int g = 0; g < BitmapFont::GLYPH_COUNT; g++) {
+            const BakedGlyph& glyph = glyphs[f][g];
+            std::fprintf(out, "    {%d, %d, %d, %d, %d, %d, %d},\n", glyph.x, glyph.y, glyph.w, glyph.h,
+                         glyph.offsetX, glyph.offsetY, glyph.advance);
+        }
+        std::fprintf(out, "},\n");
+    }
+    std::fprintf(out, "};\n");
+    
+    std::fprintf(out, "const unsigned char FONT_ATLAS_ALPHA[] = {\n");
+    for (size_t i = 0; i < atlas.size(); i++) {
+        std::fprintf(out, "%d,%s", atlas[i], (i % 32 == 31) ? "\n" : "");
+    }
+    std::fprintf(out, "\n};\n");
+    
+    if (std::fclose(out) != 0) {
+        std::fprintf(stderr, "fontbake: could not write %s\n", argv[2]);
+        return 1;
+    }
+    
+    std::printf("fontbake: %zu glyphs in a %dx%d atlas\n", bitmaps.size(), ATLAS_WIDTH, atlasHeight);
+    return 0;
+}
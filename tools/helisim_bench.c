@@ -0,0 +1,234 @@
+/*
+ * Measures per-call cost of the helisim C API.
+ *
+ *   make bench && ./helisim_bench [iterations]
+ *
+ * "step(0)" is pure call overhead, "observe" is the cost of filling an
+ * observation, "step(1)" is one simulated tick including the call,
+ * "snapshot"/"restore" fork the world state and "render/N" draws a
+ * grayscale pixel observation at 1/N resolution.
+ *
+ * "crowd" is one tick of a world holding 4096 enemies, spawned 128 at a
+ * time through helisim_set_spawning, timed before any reach the player.
+ *
+ * Also checks that a restored world replays identically and that
+ * observations stay in spawn order while scripted enemies overtake
+ * stationary ones; exits with status 1 if either fails.
+ */
+#define _POSIX_C_SOURCE 199309L
+
+#include "helisim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* EnemyType ordinals for the order check */
+#define ENEMY_STATIONARY 0
+#define ENEMY_SCRIPTED 3
+
+/* Whether ids rise through the first n entities */
+static int inSpawnOrder(const helisim_entity* entities, int32_t n) {
+    int32_t i;
+    for (i = 1; i < n; i++) {
+        if (entities[i].id <= entities[i - 1].id) return 0;
+    }
+    return 1;
+}
+
+/* Whether a scripted enemy is left of an older stationary one */
+static int overtaken(const helisim_observation* obs) {
+    int32_t i, j;
+    for (i = 0; i < obs->num_enemies; i++) {
+        if (obs->enemies[i].type != ENEMY_STATIONARY) continue;
+        for (j = i + 1; j < obs->num_enemies; j++) {
+            if (obs->enemies[j].type == ENEMY_SCRIPTED && obs->enemies[j].x < obs->enemies[i].x) return 1;
+        }
+    }
+    return 0;
+}
+
+static double nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+int main(int argc, char* argv[]) {
+    long iterations = argc > 1 ? atol(argv[1]) : 1000000;
+    helisim_world* world = helisim_create();
+    helisim_observation obs;
+    volatile int32_t sink = 0;
+    long i;
+    double start, elapsed;
+    uint32_t seed = 1;
+
+    if (!world) {
+        fprintf(stderr, "helisim_create failed\n");
+        return 1;
+    }
+
+    /* Pure call overhead */
+    start = nowNs();
+    for (i = 0; i < iterations; i++) {
+        sink += helisim_step(world, 0, 0);
+    }
+    elapsed = nowNs() - start;
+    printf("step(0):  %8.1f ns/call\n", elapsed / iterations);
+
+    /* Observation fill */
+    /* Hover mid-screen long enough for enemies and obstacles to spawn */
+    for (i = 0; i < 300; i++) {
+        helisim_observe(world, &obs);
+        helisim_step(world, 1, obs.player.y > 360.0f ? HELISIM_ACTION_THRUST : 0);
+    }
+    start = nowNs();
+    for (i = 0; i < iterations; i++) {
+        helisim_observe(world, &obs);
+        sink += obs.num_enemies;
+    }
+    elapsed = nowNs() - start;
+    printf("observe:  %8.1f ns/call (%d enemies, %d obstacles)\n",
+           elapsed / iterations, obs.num_enemies, obs.num_obstacles);
+
+    /* Simulated ticks with a simple alternating policy */
+    helisim_reset(world, seed);
+    start = nowNs();
+    for (i = 0; i < iterations; i++) {
+        uint32_t action = HELISIM_ACTION_SHOOT | ((i / 8) % 2 ? HELISIM_ACTION_THRUST : 0);
+        if (helisim_step(world, 1, action) == 0) {
+            helisim_reset(world, ++seed);
+        }
+    }
+    elapsed = nowNs() - start;
+    printf("step(1):  %8.1f ns/tick (%u resets)\n", elapsed / iterations, seed - 1);
+
+    /* Snapshot and restore of a populated world */
+    {
+        uint32_t capacity = helisim_snapshot_max_size(world);
+        unsigned char* buffer = malloc(capacity);
+        uint32_t size = 0;
+        helisim_observation before, after;
+
+        helisim_reset(world, 7);
+        for (i = 0; i < 300; i++) {
+            helisim_observe(world, &obs);
+            helisim_step(world, 1, HELISIM_ACTION_SHOOT | (obs.player.y > 360.0f ? HELISIM_ACTION_THRUST : 0));
+        }
+
+        start = nowNs();
+        for (i = 0; i < iterations; i++) {
+            size = helisim_snapshot(world, buffer, capacity);
+        }
+        elapsed = nowNs() - start;
+        printf("snapshot: %8.1f ns/call (%u of %u bytes)\n", elapsed / iterations, size, capacity);
+
+        start = nowNs();
+        for (i = 0; i < iterations; i++) {
+            sink += helisim_restore(world, buffer, size);
+        }
+        elapsed = nowNs() - start;
+        printf("restore:  %8.1f ns/call\n", elapsed / iterations);
+
+        /* Determinism check: the same actions from a restored state must
+           land in the same place */
+        helisim_step(world, 120, HELISIM_ACTION_SHOOT);
+        helisim_observe(world, &before);
+        helisim_restore(world, buffer, size);
+        helisim_step(world, 120, HELISIM_ACTION_SHOOT);
+        helisim_observe(world, &after);
+        if (before.tick != after.tick || before.player.y != after.player.y ||
+            before.score != after.score || before.num_enemies != after.num_enemies) {
+            fprintf(stderr, "restore is not deterministic\n");
+            sink = -1;
+        }
+        free(buffer);
+    }
+
+    /* Order check: scripted enemies fly faster than the scroll and pass
+       older stationary ones; the observation must still list them by age */
+    {
+        long ticks = 0, overtakes = 0;
+        uint32_t orderSeed;
+        for (orderSeed = 1; orderSeed <= 20; orderSeed++) {
+            helisim_reset(world, orderSeed);
+            for (i = 0; i < 3000; i++) {
+                helisim_observe(world, &obs);
+                if (!inSpawnOrder(obs.enemies, obs.num_enemies) ||
+                    !inSpawnOrder(obs.obstacles, obs.num_obstacles)) {
+                    fprintf(stderr, "observation out of spawn order at seed %u tick %u\n",
+                            (unsigned)orderSeed, (unsigned)obs.tick);
+                    sink = -1;
+                    break;
+                }
+                overtakes += overtaken(&obs);
+                ticks++;
+                if (helisim_step(world, 1, obs.player.y > 360.0f ? HELISIM_ACTION_THRUST : 0) == 0) break;
+            }
+        }
+        printf("order:    %ld ticks in spawn order, %ld with a stationary enemy overtaken\n", ticks, overtakes);
+        if (overtakes == 0) {
+            fprintf(stderr, "order check never saw an overtake\n");
+            sink = -1;
+        }
+    }
+
+    /* Crowd: fill to 4096 enemies, 128 per spawn every other tick, then
+       time whole ticks while they fly in. Enemies spawn at the right edge
+       and need over 250 ticks to reach the player, so none are lost to
+       collisions before timing ends. */
+    {
+        const int32_t crowd = 4096;
+        const long timedTicks = 100;
+        double total = 0.0;
+        long t;
+
+        if (helisim_set_spawning(world, 1, 0, 128, crowd) != 0) {
+            fprintf(stderr, "helisim_set_spawning failed\n");
+            sink = -1;
+        } else {
+            helisim_reset(world, 1);
+            do {
+                helisim_observe(world, &obs);
+                helisim_step(world, 1, obs.player.y > 360.0f ? HELISIM_ACTION_THRUST : 0);
+            } while (obs.total_enemies < crowd && !obs.done);
+            for (t = 0; t < timedTicks; t++) {
+                uint32_t action;
+                helisim_observe(world, &obs);
+                action = obs.player.y > 360.0f ? HELISIM_ACTION_THRUST : 0;
+                start = nowNs();
+                sink += helisim_step(world, 1, action);
+                total += nowNs() - start;
+            }
+            helisim_observe(world, &obs);
+            printf("crowd:    %8.1f ns/tick (%d enemies, %.1f ns per enemy)\n",
+                   total / timedTicks, (int)obs.total_enemies, total / timedTicks / obs.total_enemies);
+            if (obs.done || obs.total_enemies < crowd) {
+                fprintf(stderr, "crowd run ended or lost enemies (%d left)\n", (int)obs.total_enemies);
+                sink = -1;
+            }
+            helisim_reset(world, 1);
+            helisim_set_spawning(world, 120, 90, 1, 64);
+        }
+    }
+
+    /* Pixel observations at reduced resolutions */
+    for (int32_t downscale = 2; downscale <= 8; downscale *= 2) {
+        helisim_frame frame;
+        long frames = iterations / 1000 + 1;
+        if (helisim_render_init(world, downscale, 1) != 0) {
+            fprintf(stderr, "helisim_render_init failed\n");
+            break;
+        }
+        start = nowNs();
+        for (i = 0; i < frames; i++) {
+            helisim_render(world, &frame);
+            sink += frame.pixels[0];
+        }
+        elapsed = nowNs() - start;
+        printf("render/%d: %8.1f us/frame (%dx%d, %.0f frames/s)\n", (int)downscale,
+               elapsed / frames / 1000.0, (int)frame.width, (int)frame.height, frames * 1e9 / elapsed);
+    }
+
+    helisim_destroy(world);
+    return sink == -1;
+}
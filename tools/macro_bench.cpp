@@ -0,0 +1,152 @@
+/*
+ * Whole-frame benchmark over canned gameplay scenarios.
+ *
+ *   make macrobench
+ *   ./macro_bench [-s scenario]... [-o results.txt] [-l label] [--seed n]
+ *                 [--seconds n] [-w frames] [-q tier] [--render-scale percent]
+ *   ./macro_bench --compare baseline.txt current.txt [--threshold percent] [--alpha p]
+ *   ./macro_bench --list
+ *
+ * Plays each scenario (all by default) through Game::update and
+ * Game::render into an offscreen software renderer, so no display or GPU
+ * is needed and the rasterization cost is measured too. Prints per-phase
+ * frame time distributions and with -o saves every sample.
+ *
+ * --compare tests each scenario and phase of two results files with a
+ * Mann-Whitney U test and flags a regression when the median is more than
+ * --threshold percent (default 5) slower with p below --alpha (default
+ * 0.01). It exits with status 1 if there are any, to gate changes on. Both
+ * files should come from the same machine, at rest, at the same settings.
+ */
+#include "Game.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+void printUsage(const char* program) {
+    std::fprintf(stderr,
+                 "usage: %s [-s scenario]... [-o results.txt] [-l label] [--seed n] [--seconds n]\n"
+                 "          [-w frames] [-q low|medium|high] [--render-scale percent]\n"
+                 "       %s --compare baseline.txt current.txt [--threshold percent] [--alpha p]\n"
+                 "       %s --list\n", program, program, program);
+}
+
+int compareFiles(const char* baselinePath, const char* currentPath, double threshold, double alpha) {
+    BenchmarkResults baseline;
+    BenchmarkResults current;
+    if (!baseline.load(baselinePath)) {
+        std::fprintf(stderr, "Could not read results from %s\n", baselinePath);
+        return 2;
+    }
+    if (!current.load(currentPath)) {
+        std::fprintf(stderr, "Could not read results from %s\n", currentPath);
+        return 2;
+    }
+    return compareResults(baseline, current, threshold / 100.0, alpha, stdout) > 0 ? 1 : 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<const Scenario*> selected;
+    const char* outPath = nullptr;
+    const char* label = "";
+    unsigned int seed = 1;
+    int seconds = 0;
+    int warmupFrames = 60;
+    QualityTier tier = QualityTier::HIGH;
+    int renderScale = 100;
+    double threshold = 5.0;
+    double alpha = 0.01;
+    const char* comparePaths[2] = {nullptr, nullptr};
+    
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            const Scenario* scenario = Scenario::find(argv[++i]);
+            if (!scenario) {
+                std::fprintf(stderr, "Unknown scenario %s; see --list\n", argv[i]);
+                return 2;
+            }
+            selected.push_back(scenario);
+        } else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (std::strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            label = argv[++i];
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            warmupFrames = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "-q") == 0 && i + 1 < argc && parseQualityTier(argv[i + 1], tier)) {
+            i++;
+        } else if (std::strcmp(argv[i], "--render-scale") == 0 && i + 1 < argc) {
+            renderScale = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--compare") == 0 && i + 2 < argc) {
+            comparePaths[0] = argv[++i];
+            comparePaths[1] = argv[++i];
+        } else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--alpha") == 0 && i + 1 < argc) {
+            alpha = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--list") == 0) {
+            size_t count = 0;
+            const Scenario* scenarios = Scenario::getAll(count);
+            for (size_t j = 0; j < count; j++) {
+                std::printf("%-16s %4d s  %s\n", scenarios[j].name, scenarios[j].seconds, scenarios[j].description);
+            }
+            return 0;
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    
+    if (comparePaths[0]) {
+        return compareFiles(comparePaths[0], comparePaths[1], threshold, alpha);
+    }
+    
+    if (selected.empty()) {
+        size_t count = 0;
+        const Scenario* scenarios = Scenario::getAll(count);
+        for (size_t j = 0; j < count; j++) {
+            selected.push_back(&scenarios[j]);
+        }
+    }
+    
+    Game game;
+    game.enableOffscreen();
+    game.setFixedQuality(tier);
+    game.setFixedRenderScale(renderScale);
+    if (!game.init()) return 1;
+    
+    BenchmarkResults results;
+    results.label = label;
+    char settings[64];
+    std::snprintf(settings, sizeof(settings), "%s quality, %d%% resolution, seed %u",
+                  getQualityTierName(tier), renderScale, seed);
+    results.settings = settings;
+    
+    for (const Scenario* selectedScenario : selected) {
+        // --seconds shortens every scenario, e.g. for a quick look
+        Scenario scenario = *selectedScenario;
+        if (seconds > 0) scenario.seconds = seconds;
+        
+        std::fprintf(stderr, "%s: %d s of play...\n", scenario.name, scenario.seconds);
+        results.runs.emplace_back();
+        game.runBenchmark(scenario, seed, warmupFrames, results.runs.back());
+    }
+    game.cleanup();
+    
+    std::printf("Settings: %s\n", results.settings.c_str());
+    results.printSummary(stdout);
+    
+    if (outPath && !results.save(outPath)) {
+        std::fprintf(stderr, "Could not write results to %s\n", outPath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * Prints the running game's live metrics in the Prometheus text format.
+ *
+ *   make metrics && ./metrics_export [-n segment]
+ *
+ * The game publishes them to POSIX shared memory when started with
+ * --metrics (or --metrics-name). Each run takes one consistent snapshot,
+ * so this can be called by a monitoring agent on every scrape, or from
+ * cron into node_exporter's textfile directory. When no game is running
+ * only helicopter_up 0 is printed.
+ */
+#include "Metrics.h"
+#include "Game.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+const char* stateName(Uint32 state) {
+    switch (static_cast<GameState>(state)) {
+        case GameState::MENU:      return "menu";
+        case GameState::PLAYING:   return "playing";
+        case GameState::PAUSED:    return "paused";
+        case GameState::GAME_OVER: return "game_over";
+    }
+    return "unknown";
+}
+
+void gauge(const char* name, const char* help, double value) {
+    std::printf("# HELP %s %s\n# TYPE %s gauge\n%s %g\n", name, help, name, name, value);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    const char* name = METRICS_DEFAULT_NAME;
+    
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            name = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [-n segment]\n", argv[0]);
+            return 2;
+        }
+    }
+    
+    MetricsReader reader;
+    MetricsData data;
+    Uint32 pid = 0;
+    bool up = reader.open(name) && reader.read(data, pid);
+    
+    gauge("helicopter_up", "Whether a game is publishing metrics.", up ? 1 : 0);
+    if (!up) return 0;
+    
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    double nowMs = now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+    
+    std::printf("# HELP helicopter_info Publishing process.\n# TYPE helicopter_info gauge\n");
+    std::printf("helicopter_info{pid=\"%u\"} 1\n", pid);
+    gauge("helicopter_metrics_age_seconds", "Time since the game last updated its metrics.",
+          (nowMs - static_cast<double>(data.timestampMs)) / 1000.0);
+    
+    std::printf("# HELP helicopter_frame_interval_seconds Present-to-present time while playing; "
+                "quantiles over the last %d frames.\n", MetricsPublisher::WINDOW);
+    std::printf("# TYPE helicopter_frame_interval_seconds summary\n");
+    std::printf("helicopter_frame_interval_seconds{quantile=\"0.5\"} %g\n", data.intervalP50);
+    std::printf("helicopter_frame_interval_seconds{quantile=\"0.95\"} %g\n", data.intervalP95);
+    std::printf("helicopter_frame_interval_seconds{quantile=\"0.99\"} %g\n", data.intervalP99);
+    std::printf("helicopter_frame_interval_seconds{quantile=\"1\"} %g\n", data.intervalMax);
+    std::printf("helicopter_frame_interval_seconds_sum %g\n", data.frameTimeSum);
+    std::printf("helicopter_frame_interval_seconds_count %llu\n", static_cast<unsigned long long>(data.frames));
+    
+    gauge("helicopter_frame_work_seconds", "Average update and render time per frame, same window.",
+          data.workAverage);
+    gauge("helicopter_tick_rate_hertz", "Simulation ticks per second, same window.", data.tickRate);
+    
+    std::printf("# HELP helicopter_entities Live entities in the current run.\n");
+    std::printf("# TYPE helicopter_entities gauge\n");
+    std::printf("helicopter_entities{kind=\"bullets\"} %u\n", data.bullets);
+    std::printf("helicopter_entities{kind=\"enemies\"} %u\n", data.enemies);
+    std::printf("helicopter_entities{kind=\"obstacles\"} %u\n", data.obstacles);
+    std::printf("helicopter_entities{kind=\"particles\"} %u\n", data.particles);
+    
+    std::printf("# HELP helicopter_state Current game state (1 for the active one).\n");
+    std::printf("# TYPE helicopter_state gauge\n");
+    const GameState states[] = {GameState::MENU, GameState::PLAYING, GameState::PAUSED, GameState::GAME_OVER};
+    for (GameState state : states) {
+        Uint32 value = static_cast<Uint32>(state);
+        std::printf("helicopter_state{state=\"%s\"} %d\n", stateName(value), data.state == value ? 1 : 0);
+    }
+    
+    gauge("helicopter_score", "Score of the current run.", data.score);
+    gauge("helicopter_high_score", "Best score on this machine.", data.highScore);
+    gauge("helicopter_run_ticks", "Simulation ticks into the current run.", data.tick);
+    return 0;
+}
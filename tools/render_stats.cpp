@@ -0,0 +1,157 @@
+/*
+ * Headless measure of what drawing a game frame asks of the renderer.
+ *
+ *   make renderstats && ./render_stats [-f frames] [-s seed] [-q tier] [--offscreen]
+ *                                      [--render-scale percent]
+ *
+ * Plays a fixed hover-and-shoot policy and draws every tick through the
+ * counting render backend, then prints draw calls, color changes,
+ * primitives and covered pixels per frame for each part of the scene.
+ * By default drawing goes nowhere, which needs no display or GPU but takes
+ * the untextured fallback paths; --offscreen draws into a software renderer
+ * so sprite textures are used as in the game. -q draws at the low, medium
+ * or high effects tier (default high). Output is deterministic for a given
+ * seed, so two builds can be diffed to catch render cost regressions.
+ *
+ * --render-scale draws offscreen into a target texture at that scale, the
+ * way the game renders the world below 100%, and checks that the scale and
+ * viewport survive every frame, including those that bake sprites. Exits 1
+ * if they don't.
+ */
+#include "World.h"
+#include "Offscreen.h"
+#include "RenderBackend.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// Draws one frame the way Game::renderWorld does below 100% and reports
+// whether the scale and viewport it set were still in place afterwards
+bool renderScaled(World& world, CountingRenderBackend& counter, SDL_Renderer* sdl,
+                  SDL_Texture* scene, int percent) {
+    float factor = percent / 100.0f;
+    SDL_SetRenderTarget(sdl, scene);
+    SDL_RenderSetScale(sdl, factor, factor);
+    SDL_Rect viewport;
+    SDL_RenderGetViewport(sdl, &viewport);
+    
+    world.render(&counter);
+    
+    float scaleX, scaleY;
+    SDL_Rect after;
+    SDL_RenderGetScale(sdl, &scaleX, &scaleY);
+    SDL_RenderGetViewport(sdl, &after);
+    bool kept = scaleX == factor && scaleY == factor && SDL_GetRenderTarget(sdl) == scene &&
+                after.x == viewport.x && after.y == viewport.y &&
+                after.w == viewport.w && after.h == viewport.h;
+    SDL_SetRenderTarget(sdl, nullptr);
+    
+    SDL_Rect source = {0, 0, world.getWidth() * percent / 100, world.getHeight() * percent / 100};
+    counter.setSection(RenderSection::OTHER);
+    counter.copy(scene, &source, nullptr);
+    return kept;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    long frameCount = 3600;
+    unsigned int seed = 1;
+    bool offscreen = false;
+    int renderScale = 100;
+    QualityTier tier = QualityTier::HIGH;
+    
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            frameCount = std::atol(argv[++i]);
+        } else if (std::strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "-q") == 0 && i + 1 < argc && parseQualityTier(argv[i + 1], tier)) {
+            i++;
+        } else if (std::strcmp(argv[i], "--offscreen") == 0) {
+            offscreen = true;
+        } else if (std::strcmp(argv[i], "--render-scale") == 0 && i + 1 < argc) {
+            renderScale = std::atoi(argv[++i]);
+            offscreen = true;
+        } else {
+            std::fprintf(stderr, "usage: %s [-f frames] [-s seed] [-q low|medium|high] [--offscreen] "
+                         "[--render-scale percent]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (renderScale < 1 || renderScale > 100) {
+        std::fprintf(stderr, "--render-scale takes a percentage from 1 to 100\n");
+        return 2;
+    }
+    
+    World world(1280, 720);
+    world.reset(seed);
+    world.setRenderQuality(RenderQuality::forTier(tier));
+    
+    NullRenderBackend nullBackend;
+    OffscreenRenderer target;
+    SDLRenderBackend sdlBackend(nullptr);
+    RenderBackend* inner = &nullBackend;
+    if (offscreen) {
+        if (!target.init(world.getWidth(), world.getHeight(), 1, false)) {
+            std::fprintf(stderr, "Could not create offscreen renderer: %s\n", SDL_GetError());
+            return 1;
+        }
+        sdlBackend = SDLRenderBackend(target.getRenderer());
+        inner = &sdlBackend;
+    }
+    CountingRenderBackend counter(inner, world.getWidth(), world.getHeight());
+    
+    SDL_Texture* scene = nullptr;
+    if (renderScale < 100) {
+        scene = SDL_CreateTexture(target.getRenderer(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                  world.getWidth(), world.getHeight());
+        if (!scene) {
+            std::fprintf(stderr, "Could not create scene target: %s\n", SDL_GetError());
+            return 1;
+        }
+    }
+    
+    // Sprites are baked on the first frame; keep that out of the averages.
+    // Frames that bake (this one, and obstacle cache misses later) are the
+    // ones that switch render targets mid-frame.
+    long bakeFrames = 0;
+    long scaleLost = 0;
+    auto renderFrame = [&] {
+        if (scene) {
+            if (!renderScaled(world, counter, target.getRenderer(), scene, renderScale)) scaleLost++;
+        } else {
+            world.render(&counter);
+        }
+        counter.present();
+        if (counter.getFrame(RenderSection::SPRITES).drawCalls > 0) bakeFrames++;
+    };
+    renderFrame();
+    counter.resetStats();
+    
+    long resets = 0;
+    for (long frame = 0; frame < frameCount; frame++) {
+        const Helicopter& player = world.getPlayer();
+        world.step(player.getY() > world.getHeight() / 2, frame % 8 == 0);
+        if (world.isGameOver()) {
+            world.reset(seed + static_cast<unsigned int>(++resets));
+        }
+        
+        renderFrame();
+    }
+    
+    std::printf("%ld frames, seed %u, %s quality, %s, %ld resets\n", frameCount, seed,
+                getQualityTierName(tier), offscreen ? "offscreen" : "null backend", resets);
+    counter.printReport(stdout);
+    
+    if (scene) {
+        std::printf("render scale %d%%: %ld frames baked sprites, scale or viewport lost on %ld\n",
+                    renderScale, bakeFrames, scaleLost);
+        SDL_DestroyTexture(scene);
+    }
+    
+    world.releaseRenderResources();
+    return scaleLost > 0 ? 1 : 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * Nightly summary of the run history log written by the game.
+ *
+ *   make report && ./runlog_report [-n top] [runs.bin]
+ *
+ * Prints a top-N leaderboard by score, percentiles of score, distance,
+ * run length and frame time, and how runs ended. The log is memory-mapped
+ * and read in place, so millions of runs take well under a second.
+ */
+#include "RunLog.h"
+#include "World.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+const char* causeName(Uint8 cause) {
+    switch (static_cast<DeathCause>(cause)) {
+        case DeathCause::NONE:     return "-";
+        case DeathCause::ENEMY:    return "enemy";
+        case DeathCause::OBSTACLE: return "obstacle";
+        case DeathCause::TERRAIN:  return "terrain";
+    }
+    return "?";
+}
+
+void formatDate(Uint64 timestamp, char* out, size_t size) {
+    time_t t = static_cast<time_t>(timestamp);
+    struct tm local;
+    localtime_r(&t, &local);
+    strftime(out, size, "%Y-%m-%d %H:%M", &local);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t topCount = 10;
+    const char* path = "runs.bin";
+    
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            topCount = static_cast<size_t>(std::atol(argv[++i]));
+        } else {
+            path = argv[i];
+        }
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    RunLogReader log;
+    if (!log.open(path)) {
+        std::fprintf(stderr, "Could not open run log %s\n", path);
+        return 1;
+    }
+    
+    std::printf("%zu runs in %s\n", log.size(), path);
+    if (log.size() == 0) return 0;
+    
+    // Leaderboard
+    std::vector<size_t> best;
+    log.top(RunField::SCORE, topCount, best);
+    
+    std::printf("\nTop %zu by score\n", best.size());
+    std::printf("%4s %8s %8s %6s %8s %9s %-16s %10s\n",
+                "#", "score", "distance", "kills", "time(s)", "cause", "ended", "seed");
+    for (size_t i = 0; i < best.size(); i++) {
+        const RunRecord& run = log[best[i]];
+        char date[32];
+        formatDate(run.timestamp, date, sizeof(date));
+        std::printf("%4zu %8d %8d %6d %8.1f %9s %-16s %10u\n",
+                    i + 1, run.score, run.distance, run.enemiesKilled, run.ticks / 60.0,
+                    causeName(run.deathCause), date, run.seed);
+    }
+    
+    // Distributions
+    const double ps[] = {50, 90, 99, 100};
+    const size_t pCount = sizeof(ps) / sizeof(ps[0]);
+    struct Row {
+        const char* name;
+        RunField field;
+    };
+    const Row rows[] = {
+        {"score", RunField::SCORE},
+        {"distance", RunField::DISTANCE},
+        {"kills", RunField::ENEMIES_KILLED},
+        {"ticks", RunField::TICKS},
+        {"frame avg (us)", RunField::FRAME_TIME_AVG},
+        {"frame max (us)", RunField::FRAME_TIME_MAX},
+    };
+    
+    std::printf("\n%-16s %10s %10s %10s %10s\n", "percentiles", "p50", "p90", "p99", "max");
+    std::vector<Sint64> scratch;
+    for (const Row& row : rows) {
+        Sint64 values[pCount];
+        log.percentiles(row.field, ps, pCount, values, scratch);
+        std::printf("%-16s %10lld %10lld %10lld %10lld\n", row.name,
+                    static_cast<long long>(values[0]), static_cast<long long>(values[1]),
+                    static_cast<long long>(values[2]), static_cast<long long>(values[3]));
+    }
+    
+    // How runs ended
+    size_t causes[4] = {0, 0, 0, 0};
+    Uint64 slowFrames = 0;
+    Uint64 frames = 0;
+    Uint64 rewinds = 0;
+    for (size_t i = 0; i < log.size(); i++) {
+        const RunRecord& run = log[i];
+        if (run.deathCause < 4) causes[run.deathCause]++;
+        slowFrames += run.slowFrames;
+        frames += run.frames;
+        rewinds += run.rewinds;
+    }
+    
+    std::printf("\nDeaths: enemy %zu, obstacle %zu, terrain %zu\n",
+                causes[static_cast<int>(DeathCause::ENEMY)],
+                causes[static_cast<int>(DeathCause::OBSTACLE)],
+                causes[static_cast<int>(DeathCause::TERRAIN)]);
+    std::printf("Slow frames: %llu of %llu (%.3f%%), rewinds: %llu\n",
+                static_cast<unsigned long long>(slowFrames), static_cast<unsigned long long>(frames),
+                frames > 0 ? 100.0 * slowFrames / frames : 0.0,
+                static_cast<unsigned long long>(rewinds));
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("\nReport took %.3f s\n", seconds);
+    return 0;
+}